@@ -0,0 +1,132 @@
+// Copyright (c) 2017-2018 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+// The bytes currently allocated with operator new, which is replaced below so the
+// memory taken by cells can be measured without platform specific allocator hooks.
+std::atomic<std::size_t> allocated_bytes(0);
+
+// each allocation is prefixed with its size, padded to keep the rest of it aligned
+union allocation_header
+{
+    std::size_t size;
+    std::max_align_t alignment;
+};
+
+// Fill cells rows x columns of a new worksheet using set_value and print the heap
+// memory they take per cell. The workbook is created before measuring so that its
+// default stylesheet and worksheet aren't counted.
+template <typename Setter>
+void measure(const std::string &description, int rows, int columns, Setter set_value)
+{
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+    auto format = wb.create_format().number_format(xlnt::number_format::percentage_00(), true);
+
+    const auto before = allocated_bytes.load();
+
+    for (int row = 1; row <= rows; ++row)
+    {
+        for (int column = 1; column <= columns; ++column)
+        {
+            set_value(ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t::index_t>(column),
+                                  static_cast<xlnt::row_t>(row))),
+                format, row * columns + column);
+        }
+    }
+
+    const auto cells = static_cast<double>(rows) * columns;
+    const auto bytes = static_cast<double>(allocated_bytes.load() - before);
+
+    std::cout << description << ": " << bytes / cells << " bytes per cell" << '\n';
+}
+
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    auto header = static_cast<allocation_header *>(std::malloc(sizeof(allocation_header) + size));
+
+    if (header == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    header->size = size;
+    allocated_bytes += size;
+
+    return header + 1;
+}
+
+void operator delete(void *pointer) noexcept
+{
+    if (pointer == nullptr) return;
+
+    auto header = static_cast<allocation_header *>(pointer) - 1;
+    allocated_bytes -= header->size;
+    std::free(header);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+// Measures the memory taken by cells of common kinds. The shared strings and
+// formulae repeat so that the cells themselves are measured rather than the
+// strings they hold.
+int main()
+{
+    const auto rows = 50000;
+    const auto columns = 20;
+
+    measure("numbers", rows, columns, [](xlnt::cell cell, xlnt::format &, int index) {
+        cell.value(index);
+    });
+
+    measure("formatted numbers", rows, columns, [](xlnt::cell cell, xlnt::format &format, int index) {
+        cell.value(index);
+        cell.format(format);
+    });
+
+    measure("shared strings", rows, columns, [](xlnt::cell cell, xlnt::format &, int index) {
+        cell.value("string " + std::to_string(index % 100));
+    });
+
+    measure("formulae", rows, columns, [](xlnt::cell cell, xlnt::format &, int index) {
+        cell.value(index);
+        cell.formula("=A1+B1");
+    });
+
+    return 0;
+}
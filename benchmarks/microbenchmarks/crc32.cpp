@@ -0,0 +1,72 @@
+// Every byte written to a package passes through CRC-32, and at low compression levels
+// computing it is a large part of the time spent in the zip streams.
+// This compares the byte at a time table lookup miniz uses with the CRC in xlnt,
+// with and without the hardware (PCLMULQDQ) path, for buffers of several sizes.
+
+#include "benchmark/benchmark.h"
+#include <array>
+#include <random>
+#include <vector>
+
+#include <detail/serialization/crc32.hpp>
+
+namespace {
+
+std::vector<std::uint8_t> random_bytes(std::size_t size)
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dis(0, 255);
+    std::vector<std::uint8_t> bytes(size);
+
+    for (auto &byte : bytes)
+    {
+        byte = static_cast<std::uint8_t>(dis(gen));
+    }
+
+    return bytes;
+}
+
+std::uint32_t crc32_bytewise(std::uint32_t crc, const std::uint8_t *data, std::size_t size)
+{
+    static const auto table = [] {
+        std::array<std::uint32_t, 256> t{};
+        for (std::uint32_t i = 0; i < 256; ++i)
+        {
+            auto c = i;
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                c = (c >> 1) ^ (0xedb88320 & (0 - (c & 1)));
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    crc = ~crc;
+    while (size-- > 0)
+    {
+        crc = (crc >> 8) ^ table[(crc ^ *data++) & 0xff];
+    }
+    return ~crc;
+}
+
+template <std::uint32_t (*Crc)(std::uint32_t, const std::uint8_t *, std::size_t)>
+void crc32_of_buffer(benchmark::State &state)
+{
+    const auto data = random_bytes(static_cast<std::size_t>(state.range(0)));
+    std::uint32_t crc = 0;
+
+    while (state.KeepRunning())
+    {
+        crc = Crc(crc, data.data(), data.size());
+        benchmark::DoNotOptimize(crc);
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * state.range(0));
+}
+
+} // namespace
+
+BENCHMARK_TEMPLATE(crc32_of_buffer, crc32_bytewise)->Range(64, 1 << 20);
+BENCHMARK_TEMPLATE(crc32_of_buffer, xlnt::detail::update_crc32_portable)->Range(64, 1 << 20);
+BENCHMARK_TEMPLATE(crc32_of_buffer, xlnt::detail::update_crc32)->Range(64, 1 << 20);
@@ -1,13 +1,14 @@
 #include <xlnt/xlnt.hpp>
 #include <chrono>
+#include <numeric>
 #include <helpers/path_helper.hpp>
 
 namespace {
 using milliseconds_d = std::chrono::duration<double, std::milli>;
 
-void run_load_test(const xlnt::path &file, int runs = 10)
+double run_load_test(const xlnt::path &file, const xlnt::load_options &options, const std::string &mode, int runs = 10)
 {
-    std::cout << file.string() << "\n\n";
+    std::cout << file.string() << " (" << mode << ")\n\n";
 
     xlnt::workbook wb;
     std::vector<std::chrono::steady_clock::duration> test_timings;
@@ -15,7 +16,7 @@ void run_load_test(const xlnt::path &file, int runs = 10)
     for (int i = 0; i < runs; ++i)
     {
         auto start = std::chrono::steady_clock::now();
-        wb.load(file);
+        wb.load(file, options);
 
         auto end = std::chrono::steady_clock::now();
         wb.clear();
@@ -23,6 +24,24 @@ void run_load_test(const xlnt::path &file, int runs = 10)
 
         std::cout << milliseconds_d(test_timings.back()).count() << " ms\n";
     }
+
+    const auto total = std::accumulate(test_timings.begin(), test_timings.end(), std::chrono::steady_clock::duration());
+    const auto average = milliseconds_d(total).count() / runs;
+    std::cout << "average: " << average << " ms\n\n";
+
+    return average;
+}
+
+// compares the default load with load_options::values_only which skips styles, theme, comments and drawings
+void run_values_only_load_test(const xlnt::path &file, int runs = 10)
+{
+    xlnt::load_options values_only;
+    values_only.values_only = true;
+
+    const auto full = run_load_test(file, xlnt::load_options(), "default", runs);
+    const auto reduced = run_load_test(file, values_only, "values only", runs);
+
+    std::cout << "values only speedup: " << full / reduced << "x\n\n";
 }
 
 void run_save_test(const xlnt::path &file, int runs = 10)
@@ -50,8 +69,8 @@ void run_save_test(const xlnt::path &file, int runs = 10)
 
 int main()
 {
-    run_load_test(path_helper::benchmark_file("large.xlsx"));
-    run_load_test(path_helper::benchmark_file("very_large.xlsx"));
+    run_values_only_load_test(path_helper::benchmark_file("large.xlsx"));
+    run_values_only_load_test(path_helper::benchmark_file("very_large.xlsx"));
 
     run_save_test(path_helper::benchmark_file("large.xlsx"));
     run_save_test(path_helper::benchmark_file("very_large.xlsx"));
@@ -0,0 +1,155 @@
+// Copyright (c) 2017-2018 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include <xlnt/xlnt.hpp>
+#include <xlnt/workbook/streaming_workbook_reader.hpp>
+#include <detail/serialization/vector_streambuf.hpp>
+#include <detail/serialization/zstream.hpp>
+
+namespace {
+
+// Resident set size of this process in MB, or 0 where it can't be read.
+double resident_megabytes()
+{
+#ifndef _WIN32
+    std::ifstream statm("/proc/self/statm");
+    std::size_t size = 0, resident = 0;
+
+    if (statm >> size >> resident)
+    {
+        return static_cast<double>(resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE))) / (1024 * 1024);
+    }
+#endif
+    return 0;
+}
+
+// Writes a workbook whose only worksheet has the given number of numeric cells. The worksheet part is
+// generated row by row straight into the package so that writing doesn't need memory for every cell.
+void write_sheet(const std::string &filename, std::size_t rows, std::size_t columns)
+{
+    xlnt::workbook wb;
+    wb.active_sheet().title("data");
+    std::vector<std::uint8_t> template_data;
+    wb.save(template_data);
+
+    xlnt::detail::vector_istreambuf template_buffer(template_data);
+    std::istream template_stream(&template_buffer);
+    xlnt::detail::izstream template_archive(template_stream);
+
+    std::ofstream file(filename, std::ios::binary);
+    xlnt::detail::ozstream archive(file);
+
+    for (const auto &part : template_archive.files())
+    {
+        auto part_buffer = archive.open(part);
+        std::ostream part_stream(part_buffer.get());
+
+        if (part.string() != "xl/worksheets/sheet1.xml")
+        {
+            part_stream << template_archive.read(part);
+            continue;
+        }
+
+        part_stream << "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\"><sheetData>";
+
+        for (std::size_t row = 1; row <= rows; ++row)
+        {
+            part_stream << "<row r=\"" << row << "\">";
+
+            for (std::size_t column = 1; column <= columns; ++column)
+            {
+                part_stream << "<c r=\""
+                            << xlnt::cell_reference(static_cast<xlnt::column_t::index_t>(column), static_cast<xlnt::row_t>(row)).to_string()
+                            << "\"><v>" << row * column << "</v></c>";
+            }
+
+            part_stream << "</row>";
+        }
+
+        part_stream << "</sheetData></worksheet>";
+    }
+}
+
+// Streams every cell of the sheet and prints the resident set size after each tenth of the cells.
+// With transient cells the numbers stay flat however large the sheet is.
+void read_sheet(const std::string &filename, std::size_t cell_count)
+{
+    xlnt::streaming_workbook_reader reader;
+    reader.open(filename);
+    reader.begin_worksheet("data");
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    const auto report_interval = std::max(cell_count / 10, std::size_t(1));
+    std::size_t cells = 0;
+    double sum = 0;
+    double first_report = 0;
+    double last_report = 0;
+
+    while (reader.has_cell())
+    {
+        sum += reader.read_cell().value<double>();
+
+        if (++cells % report_interval == 0)
+        {
+            last_report = resident_megabytes();
+            first_report = first_report == 0 ? last_report : first_report;
+            std::cout << cells << " cells read, " << last_report << " MB resident" << std::endl;
+        }
+    }
+
+    reader.end_worksheet();
+
+    const auto elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << cells << " cells in " << elapsed << " s (checksum " << sum << ")" << std::endl;
+    std::cout << "resident set growth after the first tenth: " << last_report - first_report << " MB" << std::endl;
+}
+
+} // namespace
+
+// usage: benchmark-streaming-read [cells, default 10000000]
+int main(int argc, char *argv[])
+{
+    const auto cell_count = argc > 1 ? static_cast<std::size_t>(std::strtoull(argv[1], nullptr, 10)) : std::size_t(10000000);
+    const auto columns = std::size_t(10);
+    const auto rows = std::max(cell_count / columns, std::size_t(1));
+    const auto filename = std::string("benchmark-streaming-read.xlsx");
+
+    std::cout << "writing " << rows * columns << " cells" << std::endl;
+    write_sheet(filename, rows, columns);
+    read_sheet(filename, rows * columns);
+    std::remove(filename.c_str());
+
+    return 0;
+}
@@ -21,8 +21,11 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 #include <helpers/timing.hpp>
 #include <xlnt/xlnt.hpp>
@@ -56,9 +59,94 @@ void writer(int cols, int rows)
     wb.save(filename);
 }
 
+// Create a worksheet with cells on the diagonal from A1 to XFD1048576. Its dimension
+// spans the whole sheet, so the time taken shows whether saving depends on the
+// number of cells or on the size of the dimension.
+void sparse_writer(int cells)
+{
+    xlnt::workbook wb;
+    auto ws = wb.create_sheet();
+    const auto max_column = std::uint64_t(16384); // XFD
+    const auto max_row = std::uint64_t(1048576);
+
+    for (int index = 0; index < cells; index++)
+    {
+        auto column = static_cast<xlnt::column_t::index_t>(1 + (max_column - 1) * static_cast<std::uint64_t>(index) / static_cast<std::uint64_t>(cells - 1));
+        auto row = static_cast<xlnt::row_t>(1 + (max_row - 1) * static_cast<std::uint64_t>(index) / static_cast<std::uint64_t>(cells - 1));
+
+        ws.cell(xlnt::cell_reference(column, row)).value(index);
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    wb.save("benchmark.xlsx");
+    std::chrono::duration<double, std::milli> time = std::chrono::high_resolution_clock::now() - start;
+
+    std::cout << cells << " cells on the diagonal of " << ws.calculate_dimension().to_string() << '\n'
+              << time.count() << " ms to save" << '\n' << '\n';
+}
+
 // Create a timeit call to a function and pass in keyword arguments.
 // The function is called twice, once using the standard workbook, then with the optimised one.
 // Time from the best of three is taken.
+void threaded_writer(int sheets, int rows, std::size_t threads)
+{
+    xlnt::workbook wb;
+
+    for (int sheet = 0; sheet < sheets; sheet++)
+    {
+        auto ws = wb.create_sheet();
+
+        for (int row = 0; row < rows; row++)
+        {
+            for (int column = 0; column < 10; column++)
+            {
+                ws.cell(xlnt::cell_reference(column + 1, row + 1)).value(row * 10 + column);
+            }
+        }
+    }
+
+    xlnt::save_options options;
+    options.worksheet_threads = threads;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    wb.save(xlnt::path("benchmark.xlsx"), options);
+    std::chrono::duration<double, std::milli> time = std::chrono::high_resolution_clock::now() - start;
+
+    std::cout << sheets << " sheets of " << rows << " rows with " << threads << " worksheet threads" << '\n'
+              << time.count() << " ms to save" << '\n' << '\n';
+}
+
+void compression_writer(int rows, const std::vector<int> &levels)
+{
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+
+    for (int row = 0; row < rows; row++)
+    {
+        for (int column = 0; column < 10; column++)
+        {
+            ws.cell(xlnt::cell_reference(column + 1, row + 1)).value(row * 10 + column);
+        }
+    }
+
+    std::cout << "level\tms\tbytes" << '\n';
+
+    for (auto level : levels)
+    {
+        xlnt::save_options options;
+        options.compression_level = level;
+
+        std::vector<std::uint8_t> data;
+        auto start = std::chrono::high_resolution_clock::now();
+        wb.save(data, options);
+        std::chrono::duration<double, std::milli> time = std::chrono::high_resolution_clock::now() - start;
+
+        std::cout << level << '\t' << time.count() << '\t' << data.size() << '\n';
+    }
+
+    std::cout << '\n';
+}
+
 void timer(std::function<void(int, int)> fn, int cols, int rows)
 {
     const auto repeat = std::size_t(3);
@@ -86,5 +174,15 @@ int main()
     timer(&writer, 10, 1000);
     timer(&writer, 1, 10000);
 
+    sparse_writer(2);
+    sparse_writer(1000);
+    sparse_writer(100000);
+
+    compression_writer(100000, {0, 1, 3, 6, 9});
+
+    const auto threads = std::max(std::thread::hardware_concurrency(), 1u);
+    threaded_writer(8, 20000, 1);
+    threaded_writer(8, 20000, threads);
+
     return 0;
 }
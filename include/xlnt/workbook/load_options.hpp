@@ -0,0 +1,146 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <xlnt/xlnt_config.hpp>
+#include <xlnt/cell/index_types.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// Controls how workbook::load reads an XLSX package. A default-constructed
+/// load_options reproduces the behaviour of workbook::load without options.
+/// </summary>
+class XLNT_API load_options
+{
+public:
+    /// <summary>
+    /// The number of threads used to inflate and parse worksheet parts. Each
+    /// worksheet is read into its own worksheet on one of the threads. Values
+    /// of 0 or 1 read every worksheet on the calling thread.
+    /// </summary>
+    std::size_t worksheet_threads = 1;
+
+    /// <summary>
+    /// If true, the cell data of each worksheet is parsed on a second thread
+    /// while the cells parsed so far are added to the worksheet, with a bounded
+    /// number of cells in between.
+    /// </summary>
+    bool pipeline_sheet_data = false;
+
+    /// <summary>
+    /// The number of background threads which inflate the shared strings, stylesheet,
+    /// theme and worksheet parts into memory, in the order they're read, while the
+    /// parts before them are parsed. 0 inflates each part as it's read.
+    /// </summary>
+    std::size_t prefetch_threads = 0;
+
+    /// <summary>
+    /// The most memory in bytes used by parts inflated ahead of time by prefetch_threads.
+    /// Parts larger than this are inflated as they're read.
+    /// </summary>
+    std::size_t prefetch_memory = 256 * 1024 * 1024;
+
+    /// <summary>
+    /// If true, only the workbook-level parts are read by workbook::load. Each
+    /// worksheet is read the first time it is accessed and the package is kept
+    /// open by the workbook until every worksheet has been read.
+    /// </summary>
+    bool lazy_worksheets = false;
+
+    /// <summary>
+    /// The size in bytes of the buffers used to read and decompress each part of
+    /// the package. Larger buffers mean fewer reads from the underlying stream.
+    /// The cells of a worksheet are read through a buffer of this size, which only
+    /// grows to hold a single row that doesn't fit in it.
+    /// </summary>
+    std::size_t buffer_size = 65536;
+
+    /// <summary>
+    /// If true, the compressed parts of each worksheet, including its relationships,
+    /// comments and drawings, are kept in memory after loading. workbook::save then
+    /// copies them into the new package unchanged for every worksheet which hasn't
+    /// been changed through its worksheet or cells since loading, as long as the
+    /// cell formats and the active sheet of the workbook haven't changed either.
+    /// Reading a worksheet doesn't count as a change, but getting a cell's hyperlink
+    /// or a sheet view, which can be changed through what is returned, does. Worksheets read
+    /// partially with worksheet_columns or worksheet_rows are always written again.
+    /// </summary>
+    bool copy_unmodified_worksheets = false;
+
+    /// <summary>
+    /// If true, only cell values are read. The stylesheet is reduced to the number
+    /// formats of date and time cells and the theme, comments, drawings and images
+    /// are skipped. Cells are left without a format except for numbers with a date
+    /// or time number format, so that cell::is_date still works. A workbook loaded
+    /// this way can't be saved.
+    /// </summary>
+    bool values_only = false;
+
+    /// <summary>
+    /// The titles of the worksheets to read. Worksheets with other titles are left
+    /// out of the loaded workbook. If empty, every worksheet is read.
+    /// </summary>
+    std::unordered_set<std::string> worksheet_titles;
+
+    /// <summary>
+    /// The columns to read from each worksheet, keyed by worksheet title. Cells in
+    /// other columns are skipped while the worksheet is parsed. Worksheets without
+    /// an entry keep every column.
+    /// </summary>
+    std::unordered_map<std::string, std::vector<column_t>> worksheet_columns;
+
+    /// <summary>
+    /// Adds the columns from first to last inclusive to the columns read from
+    /// the worksheet with the given title. Throws invalid_parameter if first is
+    /// zero or last is before first.
+    /// </summary>
+    void keep_columns(const std::string &title, column_t first, column_t last);
+
+    /// <summary>
+    /// The first and last row to read from each worksheet, keyed by worksheet title.
+    /// Rows outside of the range are skipped and the worksheet part isn't
+    /// decompressed further once a row after the range has been found. Only cells
+    /// and row properties are read from these worksheets, the elements following the
+    /// cell data such as merged cells, hyperlinks and page setup as well as comments
+    /// and drawings are left out.
+    /// </summary>
+    std::unordered_map<std::string, std::pair<row_t, row_t>> worksheet_rows;
+
+    /// <summary>
+    /// Sets the rows read from the worksheet with the given title to the rows from
+    /// first to last inclusive. Throws invalid_parameter if first is zero or last
+    /// is before first.
+    /// </summary>
+    void keep_rows(const std::string &title, row_t first, row_t last);
+};
+
+} // namespace xlnt
@@ -0,0 +1,100 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <xlnt/xlnt_config.hpp>
+#include <xlnt/cell/cell_type.hpp>
+#include <xlnt/cell/index_types.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// The cells of a number of consecutive rows read by streaming_workbook_reader::read_rows.
+/// Each cell is an element of the parallel arrays below, in the order the cells
+/// appear in the worksheet. The strings of all cells share one character buffer.
+/// </summary>
+class XLNT_API row_batch
+{
+public:
+    /// <summary>
+    /// The number of rows read into this batch, including rows without cells.
+    /// </summary>
+    std::size_t row_count = 0;
+
+    /// <summary>
+    /// The row index of each cell.
+    /// </summary>
+    std::vector<row_t> rows;
+
+    /// <summary>
+    /// The column index of each cell.
+    /// </summary>
+    std::vector<column_t::index_t> columns;
+
+    /// <summary>
+    /// The type of each cell.
+    /// </summary>
+    std::vector<cell_type> types;
+
+    /// <summary>
+    /// The numeric value of each cell. This is the number of number and date cells,
+    /// 1 or 0 for boolean cells and the index into the shared string table for shared
+    /// string cells. It is 0 for other cells.
+    /// </summary>
+    std::vector<double> numbers;
+
+    /// <summary>
+    /// The offset of the text of each cell in string_data, followed by the size of
+    /// string_data, so that the text of cell i is the characters from
+    /// string_offsets[i] up to string_offsets[i + 1]. Shared strings are resolved,
+    /// number and boolean cells have no text.
+    /// </summary>
+    std::vector<std::size_t> string_offsets = {0};
+
+    /// <summary>
+    /// The text of all cells one after another.
+    /// </summary>
+    std::string string_data;
+
+    /// <summary>
+    /// Returns the number of cells in this batch.
+    /// </summary>
+    std::size_t size() const;
+
+    /// <summary>
+    /// Returns the text of the cell at the given position in the batch.
+    /// </summary>
+    std::string string(std::size_t index) const;
+
+    /// <summary>
+    /// Removes all cells and rows from this batch, keeping its allocated memory.
+    /// </summary>
+    void clear();
+};
+
+} // namespace xlnt
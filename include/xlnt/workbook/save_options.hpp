@@ -0,0 +1,95 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// Controls how workbook::save writes an XLSX package. A default-constructed
+/// save_options reproduces the behaviour of workbook::save without options.
+/// </summary>
+class XLNT_API save_options
+{
+public:
+    /// <summary>
+    /// The number of threads used to serialize and compress worksheet parts. Each
+    /// worksheet, together with its relationships, comments and drawings, is
+    /// compressed into memory on one of the threads and then copied into the
+    /// package in the usual order, so the package is the same as the one written
+    /// by a single thread. Values of 0 or 1 write every worksheet on the calling
+    /// thread.
+    /// </summary>
+    std::size_t worksheet_threads = 1;
+
+    /// <summary>
+    /// The number of threads used to compress each part. Parts larger than a block
+    /// of 1 MiB are split into blocks which are compressed concurrently while the
+    /// part is still being serialized, so that a single large worksheet uses more
+    /// than one core. The package is slightly larger than with one thread. With
+    /// worksheet_threads, each worksheet thread uses this many threads. Values of
+    /// 0 or 1 compress on the thread serializing the part.
+    /// </summary>
+    std::size_t compression_threads = 1;
+
+    /// <summary>
+    /// The deflate level used to compress each part, from 1 for the fastest to 9 for
+    /// the smallest package. Level 0 stores parts uncompressed using the STORE method,
+    /// which is the quickest to write and to read back, for example for intermediate
+    /// files. The default is 6.
+    /// </summary>
+    int compression_level = 6;
+
+    /// <summary>
+    /// Compression levels for individual parts keyed by their path in the package,
+    /// such as "xl/media/image1.png", overriding compression_level. Level 0 stores
+    /// the part uncompressed, which suits parts that are already compressed.
+    /// </summary>
+    std::unordered_map<std::string, int> part_compression_levels;
+
+    /// <summary>
+    /// The size in bytes of the buffers used to compress and write each part of the
+    /// package. Larger buffers mean fewer calls to deflate and fewer writes to the
+    /// underlying stream.
+    /// </summary>
+    std::size_t buffer_size = 65536;
+
+    /// <summary>
+    /// If true, every part is written with a ZIP64 extra field in its headers and
+    /// the package ends with the ZIP64 end of central directory records, whatever
+    /// its size. A part that grows past 4 GiB then keeps its sizes in its local
+    /// header, which readers that stream the package need to find its end. Each
+    /// part takes 48 bytes more. Otherwise, which is the default, only parts and
+    /// packages too large for the 32-bit fields use ZIP64.
+    /// </summary>
+    bool zip64 = false;
+};
+
+} // namespace xlnt
@@ -30,6 +30,8 @@
 #include <vector>
 
 #include <xlnt/xlnt_config.hpp>
+#include <xlnt/cell/index_types.hpp>
+#include <xlnt/workbook/row_batch.hpp>
 
 namespace xml {
 class parser;
@@ -41,6 +43,7 @@ class cell;
 template <typename T>
 class optional;
 class path;
+class row_properties;
 class workbook;
 class worksheet;
 
@@ -67,10 +70,27 @@ public:
 
     /// <summary>
     /// Reads the next cell in the current worksheet and optionally returns it if
-    /// the last cell in the sheet has not yet been read.
+    /// the last cell in the sheet has not yet been read. The returned cell is a view
+    /// which is overwritten by the next call and isn't stored in the worksheet, so
+    /// reading a worksheet takes the same amount of memory regardless of its size.
     /// </summary>
     cell read_cell();
 
+    /// <summary>
+    /// Reads the cells of the next count rows of the current worksheet, or of the
+    /// remaining rows if there are fewer, into a batch of parallel arrays. The batch
+    /// is owned by this reader and is overwritten by the next call, so that its
+    /// memory is reused. An empty batch means that every row has been read.
+    /// </summary>
+    const row_batch &read_rows(std::size_t count);
+
+    /// <summary>
+    /// Returns the properties of the row containing the cell last returned by
+    /// read_cell(). Like the cell, they are overwritten once the next row is read
+    /// and aren't stored in the worksheet.
+    /// </summary>
+    const row_properties &current_row_properties() const;
+
     bool has_worksheet(const std::string &name);
 
     /// <summary>
@@ -79,6 +99,16 @@ public:
     /// </summary>
     void begin_worksheet(const std::string &name);
 
+    /// <summary>
+    /// Begins reading of the worksheet with the given title like begin_worksheet(name)
+    /// but only reads the cells in the rows from first_row to last_row inclusive.
+    /// Rows before first_row are skipped and has_cell() returns false once the last
+    /// row of the range has been read, without decompressing the rest of the worksheet.
+    /// end_worksheet() then returns the worksheet without reading the elements
+    /// following the cell data.
+    /// </summary>
+    void begin_worksheet(const std::string &name, row_t first_row, row_t last_row);
+
     /// <summary>
     /// Ends reading of the current worksheet in the workbook and optionally
     /// returns a worksheet object corresponding to the worksheet with the title
@@ -138,6 +168,7 @@ private:
     std::unique_ptr<std::istream> part_stream_;
     std::unique_ptr<std::streambuf> part_stream_buffer_;
     std::unique_ptr<xml::parser> parser_;
+    row_batch batch_;
 };
 
 } // namespace xlnt
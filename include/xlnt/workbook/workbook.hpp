@@ -53,6 +53,8 @@ class const_worksheet_iterator;
 class fill;
 class font;
 class format;
+class load_options;
+class save_options;
 class rich_text;
 class manifest;
 class metadata_property;
@@ -516,6 +518,45 @@ public:
     /// </summary>
     void save(std::ostream &stream, const std::string &password) const;
 
+    /// <summary>
+    /// Serializes the workbook into an XLSX file and saves the bytes into
+    /// byte vector data. The file is written according to options.
+    /// </summary>
+    void save(std::vector<std::uint8_t> &data, const save_options &options) const;
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file and saves the data into a file
+    /// named filename. The file is written according to options.
+    /// </summary>
+    void save(const xlnt::path &filename, const save_options &options) const;
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file and saves the data into stream.
+    /// The file is written according to options.
+    /// </summary>
+    void save(std::ostream &stream, const save_options &options) const;
+
+    /// <summary>
+    /// Saves the workbook over the package named filename, typically the one it was
+    /// loaded from. The package is written to a temporary file next to filename which
+    /// then replaces it in one step, so the existing package is left as it was if
+    /// saving fails.
+    /// Nothing is reused unless the workbook was loaded with
+    /// load_options::copy_unmodified_worksheets. Then worksheets which haven't been
+    /// modified since are copied into the new package without being serialized or
+    /// compressed again. That option has no effect together with
+    /// load_options::lazy_worksheets, so every worksheet is still read in full when
+    /// loading. For any other workbook this is a full save followed by replacing the
+    /// file.
+    /// </summary>
+    void save_incremental(const xlnt::path &filename) const;
+
+    /// <summary>
+    /// Saves the workbook over the package named filename as save_incremental(filename)
+    /// does. The package is written according to options.
+    /// </summary>
+    void save_incremental(const xlnt::path &filename, const save_options &options) const;
+
     /// <summary>
     /// Interprets byte vector data as an XLSX file and sets the content of this
     /// workbook to match that file.
@@ -578,6 +619,39 @@ public:
     /// </summary>
     void load(std::istream &stream, const std::string &password);
 
+    /// <summary>
+    /// Interprets byte vector data as an XLSX file and sets the content of this
+    /// workbook to match that file. The file is read according to options.
+    /// </summary>
+    void load(const std::vector<std::uint8_t> &data, const load_options &options);
+
+    /// <summary>
+    /// Interprets the size bytes at data as an XLSX file and sets the content of
+    /// this workbook to match that file. Parts are read straight from data without
+    /// copying it, so data only needs to stay valid until this returns.
+    /// </summary>
+    void load(const std::uint8_t *data, std::size_t size);
+
+    /// <summary>
+    /// Interprets the size bytes at data as an XLSX file and sets the content of
+    /// this workbook to match that file. The file is read according to options.
+    /// With options.lazy_worksheets the workbook keeps a copy of data.
+    /// </summary>
+    void load(const std::uint8_t *data, std::size_t size, const load_options &options);
+
+    /// <summary>
+    /// Interprets file with the given filename as an XLSX file and sets the
+    /// content of this workbook to match that file. The file is read according
+    /// to options.
+    /// </summary>
+    void load(const xlnt::path &filename, const load_options &options);
+
+    /// <summary>
+    /// Interprets data in stream as an XLSX file and sets the content of this
+    /// workbook to match that file. The file is read according to options.
+    /// </summary>
+    void load(std::istream &stream, const load_options &options);
+
     // View
 
     /// <summary>
@@ -168,9 +168,9 @@ void open_file(xlnt::streaming_workbook_reader &reader, pybind11::object file)
 }
 
 template<typename T>
-T cell_value(xlnt::cell cell)
+T cell_value(const xlnt::row_batch &batch, std::size_t index)
 {
-    return static_cast<T>(cell.value<double>());
+    return static_cast<T>(batch.numbers[index]);
 }
 
 // from https://stackoverflow.com/questions/1659440/32-bit-to-16-bit-floating-point-conversion
@@ -184,9 +184,12 @@ std::uint16_t float_to_half(float f)
     return half;
 }
 
-void append_cell_value(arrow::ArrayBuilder *builder, arrow::Type::type type, xlnt::cell cell)
+void append_cell_value(arrow::ArrayBuilder *builder, arrow::Type::type type,
+    const xlnt::row_batch &batch, std::size_t index)
 {
-    const status = arrow::Status::OK();
+    const auto string_data = batch.string_data.data() + batch.string_offsets[index];
+    const auto string_length = static_cast<std::int32_t>(batch.string_offsets[index + 1] - batch.string_offsets[index]);
+    auto status = arrow::Status::OK();
 
     switch (type)
     {
@@ -195,132 +198,132 @@ void append_cell_value(arrow::ArrayBuilder *builder, arrow::Type::type type, xln
 
     case arrow::Type::BOOL:
         status = static_cast<arrow::BooleanBuilder *>(builder)
-            ->Append(cell.value<bool>());
+            ->Append(batch.numbers[index] != 0);
         break;
 
     case arrow::Type::UINT8:
         status = static_cast<arrow::UInt8Builder *>(builder)
-            ->Append(cell_value<std::uint8_t>(cell));
+            ->Append(cell_value<std::uint8_t>(batch, index));
         break;
 
     case arrow::Type::INT8:
         status = static_cast<arrow::Int8Builder *>(builder)
-          ->Append(cell_value<std::uint8_t>(cell));
+          ->Append(cell_value<std::uint8_t>(batch, index));
         break;
 
     case arrow::Type::UINT16:
         status = static_cast<arrow::UInt16Builder *>(builder)
-            ->Append(cell_value<std::uint16_t>(cell));
+            ->Append(cell_value<std::uint16_t>(batch, index));
         break;
 
     case arrow::Type::INT16:
         status = static_cast<arrow::Int16Builder *>(builder)
-            ->Append(cell_value<std::int16_t>(cell));
+            ->Append(cell_value<std::int16_t>(batch, index));
         break;
 
     case arrow::Type::UINT32:
         status = static_cast<arrow::UInt32Builder *>(builder)
-            ->Append(cell_value<std::uint32_t>(cell));
+            ->Append(cell_value<std::uint32_t>(batch, index));
         break;
 
     case arrow::Type::INT32:
         status = static_cast<arrow::Int32Builder *>(builder)
-            ->Append(cell_value<std::int32_t>(cell));
+            ->Append(cell_value<std::int32_t>(batch, index));
         break;
 
     case arrow::Type::UINT64:
         status = static_cast<arrow::UInt64Builder *>(builder)
-            ->Append(cell_value<std::uint64_t>(cell));
+            ->Append(cell_value<std::uint64_t>(batch, index));
         break;
 
     case arrow::Type::INT64:
         status = static_cast<arrow::Int64Builder *>(builder)
-            ->Append(cell_value<std::int64_t>(cell));
+            ->Append(cell_value<std::int64_t>(batch, index));
         break;
 
     case arrow::Type::HALF_FLOAT:
         status = static_cast<arrow::HalfFloatBuilder *>(builder)
-            ->Append(float_to_half(cell_value<float>(cell)));
+            ->Append(float_to_half(cell_value<float>(batch, index)));
         break;
 
     case arrow::Type::FLOAT:
         status = static_cast<arrow::FloatBuilder *>(builder)
-            ->Append(cell_value<float>(cell));
+            ->Append(cell_value<float>(batch, index));
         break;
 
     case arrow::Type::DOUBLE:
         status = static_cast<arrow::DoubleBuilder *>(builder)
-            ->Append(cell_value<double>(cell));
+            ->Append(cell_value<double>(batch, index));
         break;
 
     case arrow::Type::STRING:
         status = static_cast<arrow::StringBuilder *>(builder)
-            ->Append(cell.value<std::string>());
+            ->Append(string_data, string_length);
         break;
 
     case arrow::Type::BINARY:
         status = static_cast<arrow::BinaryBuilder *>(builder)
-            ->Append(cell.value<std::string>());
+            ->Append(string_data, string_length);
         break;
 
     case arrow::Type::FIXED_SIZE_BINARY:
         status = static_cast<arrow::FixedSizeBinaryBuilder *>(builder)
-            ->Append(cell.value<std::string>());
+            ->Append(reinterpret_cast<const std::uint8_t *>(string_data));
         break;
 
     case arrow::Type::DATE32:
         status = static_cast<arrow::Date32Builder *>(builder)
-            ->Append(cell_value<arrow::Date32Type::c_type>(cell));
+            ->Append(cell_value<arrow::Date32Type::c_type>(batch, index));
         break;
 
     case arrow::Type::DATE64:
         status = static_cast<arrow::Date64Builder *>(builder)
-            ->Append(cell_value<arrow::Date64Type::c_type>(cell));
+            ->Append(cell_value<arrow::Date64Type::c_type>(batch, index));
         break;
 
     case arrow::Type::TIMESTAMP:
         status = static_cast<arrow::TimestampBuilder *>(builder)
-            ->Append(cell_value<arrow::TimestampType::c_type>(cell));
+            ->Append(cell_value<arrow::TimestampType::c_type>(batch, index));
         break;
 
     case arrow::Type::TIME32:
         status = static_cast<arrow::Time32Builder *>(builder)
-            ->Append(cell_value<arrow::Time32Type::c_type>(cell));
+            ->Append(cell_value<arrow::Time32Type::c_type>(batch, index));
         break;
 
     case arrow::Type::TIME64:
         status = static_cast<arrow::Time64Builder *>(builder)
-            ->Append(cell_value<arrow::Time64Type::c_type>(cell));
+            ->Append(cell_value<arrow::Time64Type::c_type>(batch, index));
         break;
 /*
     case arrow::Type::INTERVAL:
         status = static_cast<arrow::IntervalBuilder *>(builder)
-            ->Append(cell_value<std::int64_t>(cell));
+            ->Append(cell_value<std::int64_t>(batch, index));
         break;
 
     case arrow::Type::DECIMAL:
         status = static_cast<arrow::DecimalBuilder *>(builder)
-            ->Append(cell.value<std::string>());
+            ->Append(string_data, string_length);
         break;
 
     case arrow::Type::LIST:
         status = static_cast<arrow::ListBuilder *>(builder)
-            ->Append(cell.value<std::string>());
+            ->Append(string_data, string_length);
         break;
 
     case arrow::Type::STRUCT:
         status = static_cast<arrow::StructBuilder *>(builder)
-            ->Append(cell.value<std::string>());
+            ->Append(string_data, string_length);
         break;
 
     case arrow::Type::UNION:
         status = static_cast<arrow::UnionBuilder *>(builder)
-            ->Append(cell.value<std::string>());
+            ->Append(string_data, string_length);
         break;
 
     case arrow::Type::DICTIONARY:
         status = static_cast<arrow::DictionaryBuilder *>(builder)
-            ->Append(cell.value<std::string>());
+            ->Append(string_data, string_length);
         break;
 */
     default:
@@ -355,25 +358,55 @@ pybind11::handle read_batch(xlnt::streaming_workbook_reader &reader,
         builders.emplace_back(make_array_builder(type));
     }
 
+    // cells are appended to the builder of their column, columns without a cell in a row are null
+    const auto &batch = reader.read_rows(static_cast<std::size_t>(max_rows));
+    const auto column_count = column_types.size();
     auto row = std::int64_t(0);
+    auto current_row = xlnt::row_t(0);
+    auto next_column = std::size_t(0);
 
-    while (row < max_rows)
-    {
-        if (!reader.has_cell()) break;
+    auto finish_row = [&]() {
+        for (; next_column < column_count; ++next_column)
+        {
+            builders.at(next_column)->AppendNull();
+        }
+
+        ++row;
+    };
 
-        for (auto column = 0; column < schema->num_fields(); ++column)
+    for (auto index = std::size_t(0); index < batch.size(); ++index)
+    {
+        if (batch.rows[index] != current_row)
         {
-            if (!reader.has_cell()) break;
+            if (current_row != 0)
+            {
+                finish_row();
+            }
+
+            current_row = batch.rows[index];
+            next_column = 0;
+        }
 
-            auto cell = reader.read_cell();
-            auto zero_indexed_column = cell.column().index - 1;
-            auto column_type = column_types.at(zero_indexed_column);
-            auto builder = builders.at(zero_indexed_column).get();
+        auto zero_indexed_column = static_cast<std::size_t>(batch.columns[index] - 1);
 
-            append_cell_value(builder, column_type, cell);
+        if (zero_indexed_column >= column_count || zero_indexed_column < next_column)
+        {
+            continue;
         }
 
-        ++row;
+        for (; next_column < zero_indexed_column; ++next_column)
+        {
+            builders.at(next_column)->AppendNull();
+        }
+
+        append_cell_value(builders.at(zero_indexed_column).get(),
+            column_types.at(zero_indexed_column), batch, index);
+        next_column = zero_indexed_column + 1;
+    }
+
+    if (current_row != 0)
+    {
+        finish_row();
     }
 
     auto columns = std::vector<std::shared_ptr<arrow::Array>>();
@@ -208,42 +208,56 @@ void cell::value(std::nullptr_t)
 
 void cell::value(bool boolean_value)
 {
+    d_->parent_->modified_ = true;
+
     d_->type_ = type::boolean;
     d_->value_numeric_ = boolean_value ? 1.0 : 0.0;
 }
 
 void cell::value(int int_value)
 {
+    d_->parent_->modified_ = true;
+
     d_->value_numeric_ = static_cast<double>(int_value);
     d_->type_ = type::number;
 }
 
 void cell::value(unsigned int int_value)
 {
+    d_->parent_->modified_ = true;
+
     d_->value_numeric_ = static_cast<double>(int_value);
     d_->type_ = type::number;
 }
 
 void cell::value(long long int int_value)
 {
+    d_->parent_->modified_ = true;
+
     d_->value_numeric_ = static_cast<double>(int_value);
     d_->type_ = type::number;
 }
 
 void cell::value(unsigned long long int int_value)
 {
+    d_->parent_->modified_ = true;
+
     d_->value_numeric_ = static_cast<double>(int_value);
     d_->type_ = type::number;
 }
 
 void cell::value(float float_value)
 {
+    d_->parent_->modified_ = true;
+
     d_->value_numeric_ = static_cast<double>(float_value);
     d_->type_ = type::number;
 }
 
 void cell::value(double float_value)
 {
+    d_->parent_->modified_ = true;
+
     d_->value_numeric_ = static_cast<double>(float_value);
     d_->type_ = type::number;
 }
@@ -255,6 +269,8 @@ void cell::value(const std::string &s)
 
 void cell::value(const rich_text &text)
 {
+    d_->parent_->modified_ = true;
+
     check_string(text.plain_text());
 
     d_->type_ = type::shared_string;
@@ -268,16 +284,45 @@ void cell::value(const char *c)
 
 void cell::value(const cell c)
 {
+    d_->parent_->modified_ = true;
+
     d_->type_ = c.d_->type_;
     d_->value_numeric_ = c.d_->value_numeric_;
-    d_->value_text_ = c.d_->value_text_;
-    d_->hyperlink_ = c.d_->hyperlink_;
-    d_->formula_ = c.d_->formula_;
     d_->format_ = c.d_->format_;
+
+    if (c.d_->has_text_)
+    {
+        d_->text(c.d_->text());
+    }
+    else
+    {
+        d_->clear_text();
+    }
+
+    if (c.d_->has_hyperlink_)
+    {
+        auto hyperlink = c.d_->hyperlink();
+        d_->reset_hyperlink() = std::move(hyperlink);
+    }
+    else
+    {
+        d_->clear_hyperlink();
+    }
+
+    if (c.d_->has_formula_)
+    {
+        d_->formula(c.d_->formula());
+    }
+    else
+    {
+        d_->clear_formula();
+    }
 }
 
 void cell::value(const date &d)
 {
+    d_->parent_->modified_ = true;
+
     d_->type_ = type::number;
     d_->value_numeric_ = d.to_number(base_date());
     number_format(number_format::date_yyyymmdd2());
@@ -285,6 +330,8 @@ void cell::value(const date &d)
 
 void cell::value(const datetime &d)
 {
+    d_->parent_->modified_ = true;
+
     d_->type_ = type::number;
     d_->value_numeric_ = d.to_number(base_date());
     number_format(number_format::date_datetime());
@@ -292,6 +339,8 @@ void cell::value(const datetime &d)
 
 void cell::value(const time &t)
 {
+    d_->parent_->modified_ = true;
+
     d_->type_ = type::number;
     d_->value_numeric_ = t.to_number();
     number_format(number_format::date_time6());
@@ -299,6 +348,8 @@ void cell::value(const time &t)
 
 void cell::value(const timedelta &t)
 {
+    d_->parent_->modified_ = true;
+
     d_->type_ = type::number;
     d_->value_numeric_ = t.to_number();
     number_format(xlnt::number_format("[hh]:mm:ss"));
@@ -321,6 +372,7 @@ column_t::index_t cell::column_index() const
 
 void cell::merged(bool merged)
 {
+    d_->parent_->modified_ = true;
     d_->is_merged_ = merged;
 }
 
@@ -336,6 +388,7 @@ bool cell::phonetics_visible() const
 
 void cell::show_phonetics(bool phonetics)
 {
+    d_->parent_->modified_ = true;
     d_->phonetics_visible_ = phonetics;
 }
 
@@ -365,11 +418,16 @@ cell &cell::operator=(const cell &rhs) = default;
 
 hyperlink cell::hyperlink() const
 {
-    return xlnt::hyperlink(&d_->hyperlink_.get());
+    // the hyperlink can be changed through the returned handle
+    d_->parent_->modified_ = true;
+
+    return xlnt::hyperlink(&d_->hyperlink());
 }
 
 void cell::hyperlink(const std::string &url, const std::string &display)
 {
+    d_->parent_->modified_ = true;
+
     if (url.empty())
     {
         throw invalid_parameter();
@@ -378,7 +436,7 @@ void cell::hyperlink(const std::string &url, const std::string &display)
     auto ws = worksheet();
     auto &manifest = ws.workbook().manifest();
 
-    d_->hyperlink_ = detail::hyperlink_impl();
+    auto &link = d_->reset_hyperlink();
 
     // check for existing relationships
     auto relationships = manifest.relationships(ws.path(), relationship_type::hyperlink);
@@ -386,7 +444,7 @@ void cell::hyperlink(const std::string &url, const std::string &display)
         [&url](xlnt::relationship rel) { return rel.target().path().string() == url; });
     if (relation != relationships.end())
     {
-        d_->hyperlink_.get().relationship = *relation;
+        link.relationship = *relation;
     }
     else
     { // register a new relationship
@@ -396,63 +454,69 @@ void cell::hyperlink(const std::string &url, const std::string &display)
             uri(url),
             target_mode::external);
         // TODO: make manifest::register_relationship return the created relationship instead of rel id
-        d_->hyperlink_.get().relationship = manifest.relationship(ws.path(), rel_id);
+        link.relationship = manifest.relationship(ws.path(), rel_id);
     }
     // if a value is already present, the display string is ignored
     if (has_value())
     {
-        d_->hyperlink_.get().display.set(to_string());
+        link.display.set(to_string());
     }
     else
     {
-        d_->hyperlink_.get().display.set(display.empty() ? url : display);
+        link.display.set(display.empty() ? url : display);
         value(hyperlink().display());
     }
 }
 
 void cell::hyperlink(xlnt::cell target, const std::string &display)
 {
+    d_->parent_->modified_ = true;
+
     // TODO: should this computed value be a method on a cell?
     const auto cell_address = target.worksheet().title() + "!" + target.reference().to_string();
 
-    d_->hyperlink_ = detail::hyperlink_impl();
-    d_->hyperlink_.get().relationship = xlnt::relationship("", relationship_type::hyperlink,
+    auto &link = d_->reset_hyperlink();
+    link.relationship = xlnt::relationship("", relationship_type::hyperlink,
         uri(""), uri(cell_address), target_mode::internal);
     // if a value is already present, the display string is ignored
     if (has_value())
     {
-        d_->hyperlink_.get().display.set(to_string());
+        link.display.set(to_string());
     }
     else
     {
-        d_->hyperlink_.get().display.set(display.empty() ? cell_address : display);
+        link.display.set(display.empty() ? cell_address : display);
         value(hyperlink().display());
     }
 }
 
 void cell::hyperlink(xlnt::range target, const std::string &display)
 {
+    d_->parent_->modified_ = true;
+
     // TODO: should this computed value be a method on a cell?
     const auto range_address = target.target_worksheet().title() + "!" + target.reference().to_string();
 
-    d_->hyperlink_ = detail::hyperlink_impl();
-    d_->hyperlink_.get().relationship = xlnt::relationship("", relationship_type::hyperlink,
+    auto &link = d_->reset_hyperlink();
+    link.relationship = xlnt::relationship("", relationship_type::hyperlink,
         uri(""), uri(range_address), target_mode::internal);
 
     // if a value is already present, the display string is ignored
     if (has_value())
     {
-        d_->hyperlink_.get().display.set(to_string());
+        link.display.set(to_string());
     }
     else
     {
-        d_->hyperlink_.get().display.set(display.empty() ? range_address : display);
+        link.display.set(display.empty() ? range_address : display);
         value(hyperlink().display());
     }
 }
 
 void cell::formula(const std::string &formula)
 {
+    d_->parent_->modified_ = true;
+
     if (formula.empty())
     {
         return clear_formula();
@@ -460,11 +524,11 @@ void cell::formula(const std::string &formula)
 
     if (formula[0] == '=')
     {
-        d_->formula_ = formula.substr(1);
+        d_->formula(formula.substr(1));
     }
     else
     {
-        d_->formula_ = formula;
+        d_->formula(formula);
     }
 
     worksheet().register_calc_chain_in_manifest();
@@ -472,19 +536,21 @@ void cell::formula(const std::string &formula)
 
 bool cell::has_formula() const
 {
-    return d_->formula_.is_set();
+    return d_->has_formula_;
 }
 
 std::string cell::formula() const
 {
-    return d_->formula_.get();
+    return d_->formula();
 }
 
 void cell::clear_formula()
 {
+    d_->parent_->modified_ = true;
+
     if (has_formula())
     {
-        d_->formula_.clear();
+        d_->clear_formula();
         worksheet().garbage_collect_formulae();
     }
 }
@@ -500,12 +566,16 @@ std::string cell::error() const
 
 void cell::error(const std::string &error)
 {
+    d_->parent_->modified_ = true;
+
     if (error.length() == 0 || error[0] != '#')
     {
         throw invalid_data_type();
     }
 
-    d_->value_text_.plain_text(error, false);
+    rich_text text;
+    text.plain_text(error, false);
+    d_->text(std::move(text));
     d_->type_ = type::error;
 }
 
@@ -560,6 +630,7 @@ cell::type cell::data_type() const
 
 void cell::data_type(type t)
 {
+    d_->parent_->modified_ = true;
     d_->type_ = t;
 }
 
@@ -595,8 +666,10 @@ protection cell::computed_protection() const
 
 void cell::clear_value()
 {
+    d_->parent_->modified_ = true;
+
     d_->value_numeric_ = 0;
-    d_->value_text_.clear();
+    d_->clear_text();
     d_->type_ = cell::type::empty;
     clear_formula();
 }
@@ -717,7 +790,7 @@ XLNT_API rich_text cell::value() const
         return workbook().shared_strings(static_cast<std::size_t>(d_->value_numeric_));
     }
 
-    return d_->value_text_;
+    return d_->text();
 }
 
 bool cell::has_value() const
@@ -750,11 +823,13 @@ std::string cell::to_string() const
 
 bool cell::has_format() const
 {
-    return d_->format_.is_set();
+    return d_->format_ != nullptr;
 }
 
 void cell::format(const class format new_format)
 {
+    d_->parent_->modified_ = true;
+
     if (has_format())
     {
         format().d_->references -= format().d_->references > 0 ? 1 : 0;
@@ -786,6 +861,8 @@ XLNT_API std::ostream &operator<<(std::ostream &stream, const xlnt::cell &cell)
 
 void cell::value(const std::string &value_string, bool infer_type)
 {
+    d_->parent_->modified_ = true;
+
     value(value_string);
 
     if (!infer_type || value_string.empty())
@@ -838,10 +915,12 @@ void cell::value(const std::string &value_string, bool infer_type)
 
 void cell::clear_format()
 {
-    if (d_->format_.is_set())
+    d_->parent_->modified_ = true;
+
+    if (d_->format_ != nullptr)
     {
         format().d_->references -= format().d_->references > 0 ? 1 : 0;
-        d_->format_.clear();
+        d_->format_ = nullptr;
     }
 }
 
@@ -899,22 +978,22 @@ bool cell::has_style() const
 
 format cell::modifiable_format()
 {
-    if (!d_->format_.is_set())
+    if (d_->format_ == nullptr)
     {
         throw invalid_attribute();
     }
 
-    return xlnt::format(d_->format_.get());
+    return xlnt::format(d_->format_);
 }
 
 const format cell::format() const
 {
-    if (!d_->format_.is_set())
+    if (d_->format_ == nullptr)
     {
         throw invalid_attribute();
     }
 
-    return xlnt::format(d_->format_.get());
+    return xlnt::format(d_->format_);
 }
 
 alignment cell::alignment() const
@@ -949,22 +1028,24 @@ protection cell::protection() const
 
 bool cell::has_hyperlink() const
 {
-    return d_->hyperlink_.is_set();
+    return d_->has_hyperlink_;
 }
 
 // comment
 
 bool cell::has_comment()
 {
-    return d_->comment_.is_set();
+    return d_->has_comment_;
 }
 
 void cell::clear_comment()
 {
+    d_->parent_->modified_ = true;
+
     if (has_comment())
     {
         d_->parent_->comments_.erase(reference().to_string());
-        d_->comment_.clear();
+        d_->has_comment_ = false;
     }
 }
 
@@ -975,7 +1056,7 @@ class comment cell::comment()
         throw xlnt::exception("cell has no comment");
     }
 
-    return *d_->comment_.get();
+    return d_->cell_comment();
 }
 
 void cell::comment(const std::string &text, const std::string &author)
@@ -990,22 +1071,17 @@ void cell::comment(const std::string &text, const class font &comment_font, cons
 
 void cell::comment(const class comment &new_comment)
 {
-    if (has_comment())
-    {
-        *d_->comment_.get() = new_comment;
-    }
-    else
-    {
-        d_->parent_->comments_[reference().to_string()] = new_comment;
-        d_->comment_.set(&d_->parent_->comments_[reference().to_string()]);
-    }
+    d_->parent_->modified_ = true;
+
+    d_->parent_->comments_[reference().to_string()] = new_comment;
+    d_->has_comment_ = true;
 
     // offset comment 5 pixels down and 5 pixels right of the top right corner of the cell
     auto cell_position = anchor();
     cell_position.first += static_cast<int>(width()) + 5;
     cell_position.second += 5;
 
-    d_->comment_.get()->position(cell_position.first, cell_position.second);
+    d_->cell_comment().position(cell_position.first, cell_position.second);
 
     worksheet().register_comments_in_manifest();
 }
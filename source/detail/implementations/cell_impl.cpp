@@ -22,22 +22,140 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <xlnt/utils/exceptions.hpp>
+#include <xlnt/utils/numeric.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
-
 #include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/worksheet_impl.hpp>
 
 namespace xlnt {
 namespace detail {
 
 cell_impl::cell_impl()
-    : type_(cell_type::empty),
-      parent_(nullptr),
+    : parent_(nullptr),
+      value_numeric_(0),
+      format_(nullptr),
       column_(1),
       row_(1),
+      type_(cell_type::empty),
       is_merged_(false),
       phonetics_visible_(false),
-      value_numeric_(0)
+      has_text_(false),
+      has_formula_(false),
+      has_hyperlink_(false),
+      has_comment_(false)
+{
+}
+
+const rich_text &cell_impl::text() const
+{
+    static const rich_text empty;
+
+    return has_text_ ? parent_->cell_text_.at(cell_reference(column_, row_)) : empty;
+}
+
+void cell_impl::text(rich_text text)
+{
+    parent_->cell_text_[cell_reference(column_, row_)] = std::move(text);
+    has_text_ = true;
+}
+
+void cell_impl::clear_text()
+{
+    if (!has_text_) return;
+
+    parent_->cell_text_.erase(cell_reference(column_, row_));
+    has_text_ = false;
+}
+
+const std::string &cell_impl::formula() const
+{
+    if (!has_formula_)
+    {
+        throw invalid_attribute();
+    }
+
+    return parent_->cell_formulas_.at(cell_reference(column_, row_));
+}
+
+void cell_impl::formula(std::string formula)
+{
+    parent_->cell_formulas_[cell_reference(column_, row_)] = std::move(formula);
+    has_formula_ = true;
+}
+
+void cell_impl::clear_formula()
+{
+    if (!has_formula_) return;
+
+    parent_->cell_formulas_.erase(cell_reference(column_, row_));
+    has_formula_ = false;
+}
+
+hyperlink_impl &cell_impl::hyperlink() const
+{
+    if (!has_hyperlink_)
+    {
+        throw invalid_attribute();
+    }
+
+    return parent_->cell_hyperlinks_.at(cell_reference(column_, row_));
+}
+
+hyperlink_impl &cell_impl::reset_hyperlink()
+{
+    auto &hyperlink = parent_->cell_hyperlinks_[cell_reference(column_, row_)];
+    hyperlink = hyperlink_impl();
+    has_hyperlink_ = true;
+
+    return hyperlink;
+}
+
+void cell_impl::clear_hyperlink()
+{
+    if (!has_hyperlink_) return;
+
+    parent_->cell_hyperlinks_.erase(cell_reference(column_, row_));
+    has_hyperlink_ = false;
+}
+
+comment &cell_impl::cell_comment() const
+{
+    if (!has_comment_)
+    {
+        throw invalid_attribute();
+    }
+
+    return parent_->comments_.at(cell_reference(column_, row_).to_string());
+}
+
+void cell_impl::clear_attributes()
+{
+    clear_text();
+    clear_formula();
+    clear_hyperlink();
+
+    if (has_comment_)
+    {
+        parent_->comments_.erase(cell_reference(column_, row_).to_string());
+        has_comment_ = false;
+    }
+}
+
+bool operator==(const cell_impl &lhs, const cell_impl &rhs)
 {
+    // not comparing parent
+    return lhs.type_ == rhs.type_
+        && lhs.column_ == rhs.column_
+        && lhs.row_ == rhs.row_
+        && lhs.is_merged_ == rhs.is_merged_
+        && lhs.phonetics_visible_ == rhs.phonetics_visible_
+        && lhs.text() == rhs.text()
+        && float_equals(lhs.value_numeric_, rhs.value_numeric_)
+        && lhs.has_formula_ == rhs.has_formula_ && (!lhs.has_formula_ || lhs.formula() == rhs.formula())
+        && lhs.has_hyperlink_ == rhs.has_hyperlink_ && (!lhs.has_hyperlink_ || lhs.hyperlink() == rhs.hyperlink())
+        && (lhs.format_ == nullptr) == (rhs.format_ == nullptr) && (lhs.format_ == nullptr || *lhs.format_ == *rhs.format_)
+        && lhs.has_comment_ == rhs.has_comment_ && (!lhs.has_comment_ || lhs.cell_comment() == rhs.cell_comment());
 }
 
 } // namespace detail
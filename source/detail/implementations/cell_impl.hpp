@@ -40,6 +40,14 @@ namespace detail {
 
 struct worksheet_impl;
 
+/// <summary>
+/// A cell as stored by its worksheet. Only what most cells have is kept here: the
+/// type, the format, and a number which is also the value of boolean cells and
+/// the index of shared string cells. The text of inline string, formula string
+/// and error cells, formulae and hyperlinks are kept in tables of the worksheet
+/// keyed by the position of the cell, and comments in its comments_, with a flag
+/// here to say whether there is one so cells without them never look.
+/// </summary>
 struct cell_impl
 {
     cell_impl();
@@ -48,45 +56,65 @@ struct cell_impl
     cell_impl &operator=(const cell_impl &other) = default;
     cell_impl &operator=(cell_impl &&other) = default;
 
-    cell_type type_;
-
     worksheet_impl *parent_;
 
+    double value_numeric_;
+    format_impl *format_;
+
     column_t column_;
     row_t row_;
 
-    bool is_merged_;
-    bool phonetics_visible_;
+    cell_type type_;
 
-    rich_text value_text_;
-    double value_numeric_;
+    bool is_merged_ : 1;
+    bool phonetics_visible_ : 1;
+    bool has_text_ : 1;
+    bool has_formula_ : 1;
+    bool has_hyperlink_ : 1;
+    bool has_comment_ : 1;
 
-    optional<std::string> formula_;
-    optional<hyperlink_impl> hyperlink_;
-    optional<format_impl *> format_;
-    optional<comment *> comment_;
+    /// <summary>
+    /// The text of an inline string, formula string or error cell, which is empty if
+    /// it has never been set.
+    /// </summary>
+    const rich_text &text() const;
+    void text(rich_text text);
+    void clear_text();
+
+    /// <summary>
+    /// The formula of the cell without a leading '='. The getter throws
+    /// invalid_attribute if there isn't one.
+    /// </summary>
+    const std::string &formula() const;
+    void formula(std::string formula);
+    void clear_formula();
+
+    /// <summary>
+    /// The hyperlink of the cell. The first throws invalid_attribute if there isn't
+    /// one and the second replaces any hyperlink with an empty one and returns it.
+    /// </summary>
+    hyperlink_impl &hyperlink() const;
+    hyperlink_impl &reset_hyperlink();
+    void clear_hyperlink();
+
+    /// <summary>
+    /// The comment of the cell, which throws invalid_attribute if there isn't one.
+    /// </summary>
+    comment &cell_comment() const;
+
+    /// <summary>
+    /// Removes the text, formula, hyperlink and comment of the cell from the tables of
+    /// its worksheet. This is done before a cell is erased or moved.
+    /// </summary>
+    void clear_attributes();
 
     bool is_garbage_collectible() const
     {
-        return !(type_ != cell_type::empty || is_merged_ || phonetics_visible_ || formula_.is_set() || format_.is_set() || hyperlink_.is_set());
+        return !(type_ != cell_type::empty || is_merged_ || phonetics_visible_ || has_formula_ || format_ != nullptr || has_hyperlink_);
     }
 };
 
-inline bool operator==(const cell_impl &lhs, const cell_impl &rhs)
-{
-    // not comparing parent
-    return lhs.type_ == rhs.type_
-        && lhs.column_ == rhs.column_
-        && lhs.row_ == rhs.row_
-        && lhs.is_merged_ == rhs.is_merged_
-        && lhs.phonetics_visible_ == rhs.phonetics_visible_
-        && lhs.value_text_ == rhs.value_text_
-        && float_equals(lhs.value_numeric_, rhs.value_numeric_)
-        && lhs.formula_ == rhs.formula_
-        && lhs.hyperlink_ == rhs.hyperlink_
-        && (lhs.format_.is_set() == rhs.format_.is_set() && (!lhs.format_.is_set() || *lhs.format_.get() == *rhs.format_.get()))
-        && (lhs.comment_.is_set() == rhs.comment_.is_set() && (!lhs.comment_.is_set() || *lhs.comment_.get() == *rhs.comment_.get()));
-}
+bool operator==(const cell_impl &lhs, const cell_impl &rhs);
 
 } // namespace detail
 } // namespace xlnt
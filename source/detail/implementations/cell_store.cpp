@@ -0,0 +1,363 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <algorithm>
+
+#include <detail/constants.hpp>
+#include <detail/implementations/cell_store.hpp>
+
+namespace {
+
+// chunks of cells double in size from the first up to the last
+const std::size_t first_chunk_size = 16;
+const std::size_t last_chunk_size = 1024;
+
+bool column_less(const xlnt::detail::cell_impl *cell, xlnt::column_t column)
+{
+    return cell->column_ < column;
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+constexpr std::size_t cell_store::rows_per_block;
+
+cell_store::cell_store()
+{
+}
+
+cell_store::cell_store(const cell_store &other)
+{
+    *this = other;
+}
+
+cell_store &cell_store::operator=(const cell_store &other)
+{
+    if (this == &other) return *this;
+
+    clear();
+    reserve(other.size());
+
+    // the cells are copied in order, so each row is appended to in sorted order
+    for (const auto &cell : other)
+    {
+        auto &block = create_block(cell.row_);
+        auto copy = new (allocate()) cell_impl(cell);
+        block.rows[cell.row_ % rows_per_block].push_back(copy);
+        ++block.size;
+        ++size_;
+    }
+
+    return *this;
+}
+
+cell_store::~cell_store()
+{
+    clear();
+}
+
+cell_store::iterator cell_store::begin()
+{
+    return iterator(blocks_, 0);
+}
+
+cell_store::iterator cell_store::end()
+{
+    return iterator(blocks_, blocks_.size());
+}
+
+cell_store::const_iterator cell_store::begin() const
+{
+    return const_iterator(blocks_, 0);
+}
+
+cell_store::const_iterator cell_store::end() const
+{
+    return const_iterator(blocks_, blocks_.size());
+}
+
+std::size_t cell_store::size() const
+{
+    return size_;
+}
+
+bool cell_store::empty() const
+{
+    return size_ == 0;
+}
+
+cell_impl *cell_store::find(column_t column, row_t row)
+{
+    auto block = find_block(row);
+    if (block == nullptr) return nullptr;
+
+    const auto &cells = block->rows[row % rows_per_block];
+    if (cells.empty()) return nullptr;
+
+    const auto first = cells.front()->column_.index;
+    const auto last = cells.back()->column_.index;
+    if (column.index < first || column.index > last) return nullptr;
+
+    // a row without gaps, as most rows are, is indexed directly
+    if (last - first + 1 == cells.size())
+    {
+        return cells[column.index - first];
+    }
+
+    auto match = std::lower_bound(cells.begin(), cells.end(), column, column_less);
+
+    return match != cells.end() && (*match)->column_ == column ? *match : nullptr;
+}
+
+const cell_impl *cell_store::find(column_t column, row_t row) const
+{
+    return const_cast<cell_store *>(this)->find(column, row);
+}
+
+std::pair<cell_impl *, bool> cell_store::emplace(cell_impl &&cell)
+{
+    auto &block = create_block(cell.row_);
+    auto &cells = block.rows[cell.row_ % rows_per_block];
+
+    // cells are usually added left to right, so check the end of the row first
+    auto position = cells.end();
+
+    if (!cells.empty() && !(cells.back()->column_ < cell.column_))
+    {
+        position = std::lower_bound(cells.begin(), cells.end(), cell.column_, column_less);
+
+        if ((*position)->column_ == cell.column_)
+        {
+            return {*position, false};
+        }
+    }
+
+    auto created = new (allocate()) cell_impl(std::move(cell));
+    cells.insert(position, created);
+    ++block.size;
+    ++size_;
+
+    return {created, true};
+}
+
+bool cell_store::erase(column_t column, row_t row)
+{
+    auto block = find_block(row);
+    if (block == nullptr) return false;
+
+    auto &cells = block->rows[row % rows_per_block];
+    auto match = std::lower_bound(cells.begin(), cells.end(), column, column_less);
+    if (match == cells.end() || (*match)->column_ != column) return false;
+
+    destroy(*match);
+    cells.erase(match);
+    --size_;
+
+    if (--block->size == 0)
+    {
+        const auto index = row / static_cast<row_t>(rows_per_block);
+        blocks_.erase(std::lower_bound(blocks_.begin(), blocks_.end(), index, block_less));
+    }
+
+    return true;
+}
+
+void cell_store::clear()
+{
+    for (auto &cell : *this)
+    {
+        cell.~cell_impl();
+    }
+
+    blocks_.clear();
+    size_ = 0;
+    chunks_.clear();
+    chunk_used_ = 0;
+    free_cells_.clear();
+}
+
+void cell_store::reserve(std::size_t count)
+{
+    const auto available = free_cells_.size()
+        + (chunks_.empty() ? 0 : chunks_.back().capacity - chunk_used_);
+    if (count <= available) return;
+
+    // the rest of the current chunk is lost, but a reservation is usually
+    // made before anything else is allocated
+    const auto capacity = count - free_cells_.size();
+    chunks_.push_back({std::unique_ptr<cell_storage[]>(new cell_storage[capacity]), capacity});
+    chunk_used_ = 0;
+}
+
+row_t cell_store::lowest_row() const
+{
+    const auto &block = *blocks_.front().block;
+    auto row = std::size_t(0);
+
+    while (block.rows[row].empty())
+    {
+        ++row;
+    }
+
+    return blocks_.front().index * static_cast<row_t>(rows_per_block) + static_cast<row_t>(row);
+}
+
+row_t cell_store::highest_row() const
+{
+    const auto &block = *blocks_.back().block;
+    auto row = rows_per_block - 1;
+
+    while (block.rows[row].empty())
+    {
+        --row;
+    }
+
+    return blocks_.back().index * static_cast<row_t>(rows_per_block) + static_cast<row_t>(row);
+}
+
+column_t cell_store::lowest_column() const
+{
+    auto lowest = column_t(constants::max_column());
+
+    for (const auto &entry : blocks_)
+    {
+        for (const auto &cells : entry.block->rows)
+        {
+            if (!cells.empty() && cells.front()->column_ < lowest)
+            {
+                lowest = cells.front()->column_;
+            }
+        }
+    }
+
+    return lowest;
+}
+
+column_t cell_store::highest_column() const
+{
+    auto highest = column_t(constants::min_column());
+
+    for (const auto &entry : blocks_)
+    {
+        for (const auto &cells : entry.block->rows)
+        {
+            if (!cells.empty() && cells.back()->column_ > highest)
+            {
+                highest = cells.back()->column_;
+            }
+        }
+    }
+
+    return highest;
+}
+
+bool cell_store::operator==(const cell_store &other) const
+{
+    // both are visited in row-major order, so equal stores have equal sequences
+    return size_ == other.size_ && std::equal(begin(), end(), other.begin());
+}
+
+bool cell_store::block_less(const block_entry &entry, row_t index)
+{
+    return entry.index < index;
+}
+
+cell_store::row_block *cell_store::find_block(row_t row) const
+{
+    if (blocks_.empty()) return nullptr;
+
+    const auto index = row / static_cast<row_t>(rows_per_block);
+    const auto first = blocks_.front().index;
+
+    // the blocks of a sheet without empty stretches are indexed directly
+    if (index >= first && index - first < blocks_.size() && blocks_[index - first].index == index)
+    {
+        return blocks_[index - first].block.get();
+    }
+
+    auto match = std::lower_bound(blocks_.begin(), blocks_.end(), index,
+        block_less);
+
+    return match != blocks_.end() && match->index == index ? match->block.get() : nullptr;
+}
+
+cell_store::row_block &cell_store::create_block(row_t row)
+{
+    const auto index = row / static_cast<row_t>(rows_per_block);
+
+    // rows are usually added top to bottom, so check the last block first
+    if (!blocks_.empty() && blocks_.back().index == index)
+    {
+        return *blocks_.back().block;
+    }
+
+    auto position = blocks_.end();
+
+    if (!blocks_.empty() && blocks_.back().index > index)
+    {
+        position = std::lower_bound(blocks_.begin(), blocks_.end(), index,
+            block_less);
+
+        if (position->index == index)
+        {
+            return *position->block;
+        }
+    }
+
+    position = blocks_.insert(position, block_entry{index, std::unique_ptr<row_block>(new row_block())});
+
+    return *position->block;
+}
+
+void *cell_store::allocate()
+{
+    if (!free_cells_.empty())
+    {
+        auto cell = free_cells_.back();
+        free_cells_.pop_back();
+
+        return cell;
+    }
+
+    if (chunks_.empty() || chunk_used_ == chunks_.back().capacity)
+    {
+        const auto capacity = chunks_.empty()
+            ? first_chunk_size
+            : std::min(std::max(chunks_.back().capacity, first_chunk_size / 2) * 2, last_chunk_size);
+        chunks_.push_back({std::unique_ptr<cell_storage[]>(new cell_storage[capacity]), capacity});
+        chunk_used_ = 0;
+    }
+
+    return &chunks_.back().cells[chunk_used_++];
+}
+
+void cell_store::destroy(cell_impl *cell)
+{
+    cell->~cell_impl();
+    free_cells_.push_back(cell);
+}
+
+} // namespace detail
+} // namespace xlnt
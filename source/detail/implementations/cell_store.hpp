@@ -0,0 +1,272 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <detail/implementations/cell_impl.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// The cells of a worksheet. Rows are grouped into blocks of rows_per_block rows,
+/// kept sorted by their first row, and the cells of each row are kept sorted by
+/// column, so cells are found without hashing and visited in row-major order.
+/// The cells themselves are allocated in chunks in the order they're created and
+/// never move, so a pointer to a cell, such as the one in xlnt::cell, stays valid
+/// until that cell is erased.
+/// </summary>
+class cell_store
+{
+public:
+    static constexpr std::size_t rows_per_block = 16;
+
+private:
+    // the cells of one row sorted by column
+    using row_cells = std::vector<cell_impl *>;
+
+    struct row_block
+    {
+        std::array<row_cells, rows_per_block> rows;
+        std::size_t size = 0;
+    };
+
+    struct block_entry
+    {
+        row_t index;
+        std::unique_ptr<row_block> block;
+    };
+
+public:
+    /// <summary>
+    /// Visits the cells of a cell_store in row-major order.
+    /// </summary>
+    template <typename Cell>
+    class basic_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = cell_impl;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Cell *;
+        using reference = Cell &;
+
+        basic_iterator(const std::vector<block_entry> &blocks, std::size_t block)
+            : blocks_(&blocks),
+              block_(block)
+        {
+            settle();
+        }
+
+        reference operator*() const
+        {
+            return *(*blocks_)[block_].block->rows[row_][index_];
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        basic_iterator &operator++()
+        {
+            ++index_;
+            settle();
+
+            return *this;
+        }
+
+        basic_iterator operator++(int)
+        {
+            auto previous = *this;
+            ++*this;
+
+            return previous;
+        }
+
+        bool operator==(const basic_iterator &other) const
+        {
+            return block_ == other.block_ && row_ == other.row_ && index_ == other.index_;
+        }
+
+        bool operator!=(const basic_iterator &other) const
+        {
+            return !(*this == other);
+        }
+
+    private:
+        // moves forward to the first cell at or after the current position
+        void settle()
+        {
+            while (block_ < blocks_->size())
+            {
+                const auto &rows = (*blocks_)[block_].block->rows;
+
+                while (row_ < rows_per_block)
+                {
+                    if (index_ < rows[row_].size()) return;
+
+                    ++row_;
+                    index_ = 0;
+                }
+
+                ++block_;
+                row_ = 0;
+            }
+        }
+
+        const std::vector<block_entry> *blocks_;
+        std::size_t block_;
+        std::size_t row_ = 0;
+        std::size_t index_ = 0;
+    };
+
+    using iterator = basic_iterator<cell_impl>;
+    using const_iterator = basic_iterator<const cell_impl>;
+
+    cell_store();
+    cell_store(const cell_store &other);
+    cell_store &operator=(const cell_store &other);
+    ~cell_store();
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    std::size_t size() const;
+    bool empty() const;
+
+    /// <summary>
+    /// Returns the cell at column and row or nullptr if there isn't one.
+    /// </summary>
+    cell_impl *find(column_t column, row_t row);
+    const cell_impl *find(column_t column, row_t row) const;
+
+    /// <summary>
+    /// Moves cell into the store at its column_ and row_ and returns it and true,
+    /// unless there is a cell there already, in which case that one is returned
+    /// with false and cell is left as it was.
+    /// </summary>
+    std::pair<cell_impl *, bool> emplace(cell_impl &&cell);
+
+    /// <summary>
+    /// Destroys the cell at column and row, if there is one. Returns true if there was.
+    /// </summary>
+    bool erase(column_t column, row_t row);
+
+    /// <summary>
+    /// Destroys every cell for which predicate returns true, visiting them in
+    /// row-major order. predicate may modify the cells it's given.
+    /// </summary>
+    template <typename Predicate>
+    void erase_if(Predicate predicate);
+
+    void clear();
+
+    /// <summary>
+    /// Allocates memory for count more cells at once.
+    /// </summary>
+    void reserve(std::size_t count);
+
+    /// <summary>
+    /// The lowest and highest rows and columns of the cells, which must not be empty.
+    /// The rows are found from the blocks and the columns from the first and last
+    /// cell of each row, without visiting every cell.
+    /// </summary>
+    row_t lowest_row() const;
+    row_t highest_row() const;
+    column_t lowest_column() const;
+    column_t highest_column() const;
+
+    bool operator==(const cell_store &other) const;
+
+private:
+    using cell_storage = typename std::aligned_storage<sizeof(cell_impl), alignof(cell_impl)>::type;
+
+    struct chunk
+    {
+        std::unique_ptr<cell_storage[]> cells;
+        std::size_t capacity;
+    };
+
+    static bool block_less(const block_entry &entry, row_t index);
+
+    // the block of row, or nullptr if there isn't one yet
+    row_block *find_block(row_t row) const;
+    row_block &create_block(row_t row);
+
+    // memory for a new cell, which is then constructed by the caller
+    void *allocate();
+    void destroy(cell_impl *cell);
+
+    std::vector<block_entry> blocks_;
+    std::size_t size_ = 0;
+
+    std::vector<chunk> chunks_;
+    std::size_t chunk_used_ = 0;
+    std::vector<cell_impl *> free_cells_;
+};
+
+template <typename Predicate>
+void cell_store::erase_if(Predicate predicate)
+{
+    for (auto entry = blocks_.begin(); entry != blocks_.end();)
+    {
+        auto &block = *entry->block;
+
+        for (auto &row : block.rows)
+        {
+            auto kept = row.begin();
+
+            for (auto cell : row)
+            {
+                if (predicate(*cell))
+                {
+                    destroy(cell);
+                    --block.size;
+                    --size_;
+                }
+                else
+                {
+                    *kept++ = cell;
+                }
+            }
+
+            row.erase(kept, row.end());
+        }
+
+        entry = block.size == 0 ? blocks_.erase(entry) : entry + 1;
+    }
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <list>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -34,6 +35,7 @@
 #include <xlnt/utils/datetime.hpp>
 #include <xlnt/utils/variant.hpp>
 #include <xlnt/workbook/calculation_properties.hpp>
+#include <xlnt/workbook/load_options.hpp>
 #include <xlnt/workbook/theme.hpp>
 #include <xlnt/workbook/workbook_view.hpp>
 #include <xlnt/worksheet/range.hpp>
@@ -43,6 +45,7 @@
 namespace xlnt {
 namespace detail {
 
+class izstream;
 struct worksheet_impl;
 
 struct workbook_impl
@@ -64,7 +67,10 @@ struct workbook_impl
           custom_properties_(other.custom_properties_),
           view_(other.view_),
           code_name_(other.code_name_),
-          file_version_(other.file_version_)
+          file_version_(other.file_version_),
+          archive_(other.archive_),
+          load_options_(other.load_options_),
+          date_format_ids_(other.date_format_ids_)
     {
     }
 
@@ -87,6 +93,10 @@ struct workbook_impl
         extended_properties_ = other.extended_properties_;
         custom_properties_ = other.custom_properties_;
 
+        archive_ = other.archive_;
+        load_options_ = other.load_options_;
+        date_format_ids_ = other.date_format_ids_;
+
         return *this;
     }
 
@@ -159,6 +169,20 @@ struct workbook_impl
     optional<std::string> abs_path_;
     optional<std::size_t> arch_id_flags_;
     optional<ext_list> extensions_;
+
+    // the package worksheets are read from when loaded with load_options::lazy_worksheets,
+    // released once every worksheet has been read
+    std::shared_ptr<izstream> archive_;
+    load_options load_options_;
+
+    // when loaded with load_options::values_only, the id of the format given to cells with
+    // each cellXfs index of the package, which is only set for date and time number formats
+    std::vector<optional<std::size_t>> date_format_ids_;
+
+    // the cell formats and active tab when the worksheets were loaded with
+    // load_options::copy_unmodified_worksheets, which their copied parts depend on
+    std::vector<const format_impl *> raw_formats_;
+    optional<std::size_t> raw_active_tab_;
 };
 
 } // namespace detail
@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -41,6 +42,7 @@
 #include <xlnt/worksheet/print_options.hpp>
 #include <xlnt/worksheet/sheet_pr.hpp>
 #include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/cell_store.hpp>
 
 namespace xlnt {
 
@@ -48,6 +50,8 @@ class workbook;
 
 namespace detail {
 
+struct zentries;
+
 struct worksheet_impl
 {
     worksheet_impl(workbook *parent_workbook, std::size_t id, const std::string &title)
@@ -88,10 +92,16 @@ struct worksheet_impl
         extension_list_ = other.extension_list_;
         sheet_properties_ = other.sheet_properties_;
         print_options_ = other.print_options_;
+        comments_ = other.comments_;
+        cell_text_ = other.cell_text_;
+        cell_formulas_ = other.cell_formulas_;
+        cell_hyperlinks_ = other.cell_hyperlinks_;
+        unread_ = other.unread_;
+        raw_parts_.reset();
 
         for (auto &cell : cell_map_)
         {
-            cell.second.parent_ = this;
+            cell.parent_ = this;
         }
     }
 
@@ -132,7 +142,12 @@ struct worksheet_impl
     std::unordered_map<column_t, column_properties> column_properties_;
     std::unordered_map<row_t, row_properties> row_properties_;
 
-    std::unordered_map<cell_reference, cell_impl> cell_map_;
+    cell_store cell_map_;
+
+    // the parts of cells which few of them have, by the position of the cell (see cell_impl)
+    std::unordered_map<cell_reference, rich_text> cell_text_;
+    std::unordered_map<cell_reference, std::string> cell_formulas_;
+    std::unordered_map<cell_reference, hyperlink_impl> cell_hyperlinks_;
 
     optional<page_setup> page_setup_;
     optional<range_reference> auto_filter_;
@@ -161,6 +176,18 @@ struct worksheet_impl
 
     std::string drawing_rel_id_;
     optional<drawing::spreadsheet_drawing> drawing_;
+
+    // set by the worksheet and cell functions which change the worksheet, cleared once it has been
+    // loaded, so that its loaded parts are only copied on save while it's unchanged
+    bool modified_ = false;
+
+    // true until the worksheet part has been read from the workbook's archive (see load_options::lazy_worksheets)
+    bool unread_ = false;
+
+    // the compressed parts of the worksheet as they were loaded (see load_options::copy_unmodified_worksheets)
+    // and the id it had then, copied on save while the worksheet isn't modified_
+    std::shared_ptr<zentries> raw_parts_;
+    std::size_t raw_parts_id_ = 0;
 };
 
 } // namespace detail
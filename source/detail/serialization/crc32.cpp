@@ -0,0 +1,238 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <array>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define XLNT_CRC32_PCLMUL
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if defined(XLNT_CRC32_PCLMUL) && !defined(_MSC_VER)
+#define XLNT_TARGET_PCLMUL __attribute__((target("sse2,pclmul")))
+#else
+#define XLNT_TARGET_PCLMUL
+#endif
+
+#include <detail/serialization/crc32.hpp>
+
+namespace {
+
+using crc32_tables = std::array<std::array<std::uint32_t, 256>, 16>;
+
+// tables[0] is the byte-wise table of the reflected polynomial 0xedb88320 and
+// tables[k] is the contribution of a byte followed by k bytes of zeros
+crc32_tables make_tables()
+{
+    crc32_tables tables;
+
+    for (std::uint32_t i = 0; i < 256; ++i)
+    {
+        auto crc = i;
+
+        for (auto bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+        }
+
+        tables[0][i] = crc;
+    }
+
+    for (std::size_t k = 1; k < tables.size(); ++k)
+    {
+        for (std::size_t i = 0; i < 256; ++i)
+        {
+            tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xff];
+        }
+    }
+
+    return tables;
+}
+
+const crc32_tables &tables()
+{
+    static const crc32_tables tables = make_tables();
+    return tables;
+}
+
+std::uint32_t read_uint32(const std::uint8_t *data)
+{
+    return static_cast<std::uint32_t>(data[0])
+        | (static_cast<std::uint32_t>(data[1]) << 8)
+        | (static_cast<std::uint32_t>(data[2]) << 16)
+        | (static_cast<std::uint32_t>(data[3]) << 24);
+}
+
+// Updates state, which is the inverted CRC, with sixteen table lookups per sixteen bytes.
+std::uint32_t slice_by_16(std::uint32_t state, const std::uint8_t *data, std::size_t size)
+{
+    const auto &t = tables();
+
+    while (size >= 16)
+    {
+        const auto one = read_uint32(data) ^ state;
+        const auto two = read_uint32(data + 4);
+        const auto three = read_uint32(data + 8);
+        const auto four = read_uint32(data + 12);
+
+        state = t[15][one & 0xff] ^ t[14][(one >> 8) & 0xff] ^ t[13][(one >> 16) & 0xff] ^ t[12][one >> 24]
+            ^ t[11][two & 0xff] ^ t[10][(two >> 8) & 0xff] ^ t[9][(two >> 16) & 0xff] ^ t[8][two >> 24]
+            ^ t[7][three & 0xff] ^ t[6][(three >> 8) & 0xff] ^ t[5][(three >> 16) & 0xff] ^ t[4][three >> 24]
+            ^ t[3][four & 0xff] ^ t[2][(four >> 8) & 0xff] ^ t[1][(four >> 16) & 0xff] ^ t[0][four >> 24];
+
+        data += 16;
+        size -= 16;
+    }
+
+    while (size-- > 0)
+    {
+        state = (state >> 8) ^ t[0][(state ^ *data++) & 0xff];
+    }
+
+    return state;
+}
+
+#ifdef XLNT_CRC32_PCLMUL
+bool has_pclmul()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+
+    return (info[2] & (1 << 1)) != 0;
+#else
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+
+    return __get_cpuid(1, &eax, &ebx, &ecx, &edx) != 0 && (ecx & (1u << 1)) != 0;
+#endif
+}
+
+// Returns lane multiplied by the given fold constants, so that it lines up with next, xor next.
+XLNT_TARGET_PCLMUL
+__m128i fold_lane(__m128i lane, __m128i next, __m128i constants)
+{
+    const auto low = _mm_clmulepi64_si128(lane, constants, 0x00);
+    const auto high = _mm_clmulepi64_si128(lane, constants, 0x11);
+
+    return _mm_xor_si128(_mm_xor_si128(high, next), low);
+}
+
+// Updates state, which is the inverted CRC, by folding four 128-bit lanes with carry-less
+// multiplication and reducing the result with Barrett reduction, as described in Intel's
+// "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction".
+// size must be a multiple of 16 and at least 64.
+XLNT_TARGET_PCLMUL
+std::uint32_t fold_pclmul(std::uint32_t state, const std::uint8_t *data, std::size_t size)
+{
+    // the fold constants x^(4*128+32) mod P, x^(4*128-32) mod P and so on, bit-reflected
+    const auto k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+    const auto k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+    const auto k5k0 = _mm_set_epi64x(0, 0x0163cd6124);
+    const auto poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+    const auto mask = _mm_setr_epi32(~0, 0, ~0, 0);
+
+    auto x1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data));
+    auto x2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16));
+    auto x3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 32));
+    auto x4 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 48));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(state)));
+
+    data += 64;
+    size -= 64;
+
+    while (size >= 64)
+    {
+        x1 = fold_lane(x1, _mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), k1k2);
+        x2 = fold_lane(x2, _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16)), k1k2);
+        x3 = fold_lane(x3, _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 32)), k1k2);
+        x4 = fold_lane(x4, _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 48)), k1k2);
+
+        data += 64;
+        size -= 64;
+    }
+
+    // fold the four lanes and any remaining 16 byte blocks into one
+    x1 = fold_lane(x1, x2, k3k4);
+    x1 = fold_lane(x1, x3, k3k4);
+    x1 = fold_lane(x1, x4, k3k4);
+
+    while (size >= 16)
+    {
+        x1 = fold_lane(x1, _mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), k3k4);
+        data += 16;
+        size -= 16;
+    }
+
+    // fold 128 bits to 64 bits
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask);
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, k5k0, 0x00), x2);
+
+    // Barrett reduction to 32 bits
+    x2 = _mm_and_si128(x1, mask);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+    x2 = _mm_and_si128(x2, mask);
+    x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return static_cast<std::uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(x1, 4)));
+}
+#endif
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+std::uint32_t update_crc32(std::uint32_t crc, const std::uint8_t *data, std::size_t size)
+{
+#ifdef XLNT_CRC32_PCLMUL
+    static const bool pclmul = has_pclmul();
+
+    if (pclmul && size >= 64)
+    {
+        const auto folded = size & ~std::size_t(15);
+        const auto state = fold_pclmul(~crc, data, folded);
+
+        return ~slice_by_16(state, data + folded, size - folded);
+    }
+#endif
+
+    return update_crc32_portable(crc, data, size);
+}
+
+std::uint32_t update_crc32_portable(std::uint32_t crc, const std::uint8_t *data, std::size_t size)
+{
+    return ~slice_by_16(~crc, data, size);
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,48 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Returns the CRC-32 used by ZIP archives of the size bytes at data, continuing
+/// from crc, which is 0 for the first bytes, like crc32 in zlib. Uses carry-less
+/// multiplication (PCLMULQDQ) on x86-64 processors that support it, which is
+/// detected once at runtime, and update_crc32_portable otherwise.
+/// </summary>
+XLNT_API std::uint32_t update_crc32(std::uint32_t crc, const std::uint8_t *data, std::size_t size);
+
+/// <summary>
+/// Computes the same CRC as update_crc32 with tables sixteen bytes at a time,
+/// on any processor.
+/// </summary>
+XLNT_API std::uint32_t update_crc32_portable(std::uint32_t crc, const std::uint8_t *data, std::size_t size);
+
+} // namespace detail
+} // namespace xlnt
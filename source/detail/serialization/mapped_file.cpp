@@ -0,0 +1,133 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <xlnt/utils/exceptions.hpp>
+#include <xlnt/utils/path.hpp>
+#include <detail/serialization/mapped_file.hpp>
+
+namespace xlnt {
+namespace detail {
+
+#ifdef _WIN32
+mapped_file::mapped_file(const std::string &filename)
+{
+    const auto handle = CreateFileW(xlnt::path(filename).wstring().c_str(), GENERIC_READ,
+        FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        throw xlnt::exception("file not found " + filename);
+    }
+
+    file_ = handle;
+    LARGE_INTEGER file_size;
+
+    if (!GetFileSizeEx(handle, &file_size) || file_size.QuadPart == 0)
+    {
+        CloseHandle(handle);
+        throw xlnt::exception("file is empty or can't be mapped " + filename);
+    }
+
+    mapping_ = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const auto view = mapping_ != nullptr ? MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+    if (view == nullptr)
+    {
+        if (mapping_ != nullptr) CloseHandle(mapping_);
+        CloseHandle(handle);
+        throw xlnt::exception("file is empty or can't be mapped " + filename);
+    }
+
+    data_ = static_cast<const std::uint8_t *>(view);
+    size_ = static_cast<std::size_t>(file_size.QuadPart);
+}
+
+mapped_file::~mapped_file()
+{
+    UnmapViewOfFile(data_);
+    CloseHandle(mapping_);
+    CloseHandle(file_);
+}
+#else
+mapped_file::mapped_file(const std::string &filename)
+{
+    const auto descriptor = ::open(filename.c_str(), O_RDONLY);
+
+    if (descriptor == -1)
+    {
+        throw xlnt::exception("file not found " + filename);
+    }
+
+    struct stat file_status;
+
+    if (fstat(descriptor, &file_status) != 0 || file_status.st_size <= 0)
+    {
+        ::close(descriptor);
+        throw xlnt::exception("file is empty or can't be mapped " + filename);
+    }
+
+    const auto size = static_cast<std::size_t>(file_status.st_size);
+    const auto view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+    // the mapping stays valid without the descriptor
+    ::close(descriptor);
+
+    if (view == MAP_FAILED)
+    {
+        throw xlnt::exception("file is empty or can't be mapped " + filename);
+    }
+
+    data_ = static_cast<const std::uint8_t *>(view);
+    size_ = size;
+}
+
+mapped_file::~mapped_file()
+{
+    munmap(const_cast<std::uint8_t *>(data_), size_);
+}
+#endif
+
+const std::uint8_t *mapped_file::data() const
+{
+    return data_;
+}
+
+std::size_t mapped_file::size() const
+{
+    return size_;
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,76 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// A file mapped read-only into memory for as long as this object exists.
+/// </summary>
+class XLNT_API mapped_file
+{
+public:
+    /// <summary>
+    /// Maps the file at filename. Throws xlnt::exception if the file can't be
+    /// opened or mapped, which includes empty files.
+    /// </summary>
+    mapped_file(const std::string &filename);
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    /// <summary>
+    /// Unmaps the file.
+    /// </summary>
+    ~mapped_file();
+
+    /// <summary>
+    /// Returns a pointer to the first byte of the file.
+    /// </summary>
+    const std::uint8_t *data() const;
+
+    /// <summary>
+    /// Returns the size of the file in bytes.
+    /// </summary>
+    std::size_t size() const;
+
+private:
+    const std::uint8_t *data_ = nullptr;
+    std::size_t size_ = 0;
+
+#ifdef _WIN32
+    void *file_ = nullptr;
+    void *mapping_ = nullptr;
+#endif
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -21,6 +21,15 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cstdio>
+#endif
+
 #include <xlnt/utils/path.hpp>
 #include <detail/serialization/open_stream.hpp>
 
@@ -59,5 +68,20 @@ void open_stream(std::ofstream &stream, const std::string &path)
 }
 #endif
 
+#ifdef _WIN32
+bool replace_file(const std::string &source, const std::string &target)
+{
+    // rename doesn't replace an existing file on Windows, but this does so atomically
+    return MoveFileExW(xlnt::path(source).wstring().c_str(), xlnt::path(target).wstring().c_str(),
+               MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)
+        != 0;
+}
+#else
+bool replace_file(const std::string &source, const std::string &target)
+{
+    return std::rename(source.c_str(), target.c_str()) == 0;
+}
+#endif
+
 } // namespace detail
 } // namespace xlnt
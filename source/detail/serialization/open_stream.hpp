@@ -44,5 +44,11 @@ void open_stream(std::ifstream &stream, const std::string &path);
 void open_stream(std::ofstream &stream, const std::string &path);
 #endif
 
+/// <summary>
+/// Moves the file named source to target in one step, replacing target if it
+/// exists. Returns false and leaves both files as they were if that isn't possible.
+/// </summary>
+bool replace_file(const std::string &source, const std::string &target);
+
 } // namespace detail
 } // namespace xlnt
@@ -213,6 +213,41 @@ std::streampos vector_ostreambuf::seekpos(std::streampos sp, std::ios_base::open
     return static_cast<std::ptrdiff_t>(position_);
 }
 
+memory_istreambuf::memory_istreambuf(const char *data, std::size_t size)
+{
+    // the get area is only ever read from
+    auto begin = const_cast<char *>(data);
+    setg(begin, begin, begin + size);
+}
+
+std::streampos memory_istreambuf::seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode)
+{
+    auto position = off;
+
+    if (way == std::ios_base::cur)
+    {
+        position += gptr() - eback();
+    }
+    else if (way == std::ios_base::end)
+    {
+        position += egptr() - eback();
+    }
+
+    if (position < 0 || position > egptr() - eback())
+    {
+        return static_cast<std::ptrdiff_t>(-1);
+    }
+
+    setg(eback(), eback() + position, egptr());
+
+    return position;
+}
+
+std::streampos memory_istreambuf::seekpos(std::streampos sp, std::ios_base::openmode mode)
+{
+    return seekoff(sp, std::ios_base::beg, mode);
+}
+
 XLNT_API std::vector<std::uint8_t> to_vector(std::istream &in_stream)
 {
     if (!in_stream)
@@ -88,6 +88,24 @@ private:
     std::size_t position_;
 };
 
+/// <summary>
+/// Allows a contiguous block of memory owned by the caller to be read through a
+/// std::istream without copying it.
+/// </summary>
+class XLNT_API memory_istreambuf : public std::streambuf
+{
+public:
+    memory_istreambuf(const char *data, std::size_t size);
+
+    memory_istreambuf(const memory_istreambuf &) = delete;
+    memory_istreambuf &operator=(const memory_istreambuf &) = delete;
+
+private:
+    std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode);
+
+    std::streampos seekpos(std::streampos sp, std::ios_base::openmode);
+};
+
 //TODO: detail headers shouldn't be exporting such functions
 
 /// <summary>
@@ -21,9 +21,19 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <mutex>
 #include <numeric> // for std::accumulate
 #include <sstream>
+#include <thread>
 #include <unordered_map>
 
 #include <xlnt/cell/cell.hpp>
@@ -33,6 +43,7 @@
 #include <xlnt/packaging/manifest.hpp>
 #include <xlnt/utils/optional.hpp>
 #include <xlnt/utils/path.hpp>
+#include <xlnt/workbook/row_batch.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/selection.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
@@ -45,6 +56,248 @@
 #include <detail/serialization/xlsx_consumer.hpp>
 #include <detail/serialization/zstream.hpp>
 
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Reads a worksheet part for an xml::parser through a window of the part which only
+/// grows beyond its initial size to hold a single row. The parser is given the part up
+/// to the <sheetData> start tag and then whitespace while the content of the element is
+/// held back to be scanned from the window by scan_sheet_data. The rest of the part is
+/// given to the parser once it has been released. A part which can't be scanned because
+/// of its encoding or a comment, CDATA section or DTD before <sheetData> is passed through.
+/// </summary>
+class worksheet_part_streambuf : public std::streambuf
+{
+public:
+    worksheet_part_streambuf(std::streambuf &part, std::size_t buffer_size)
+        : part_(part),
+          window_(std::max(buffer_size, std::size_t(64)))
+    {
+    }
+
+    worksheet_part_streambuf(const worksheet_part_streambuf &) = delete;
+    worksheet_part_streambuf &operator=(const worksheet_part_streambuf &) = delete;
+
+    // true while the content of <sheetData> is held back from the parser
+    bool sheet_data_held() const
+    {
+        return state_ == state::held;
+    }
+
+    // the part from where scanning continues, as far as it has been read
+    const char *data() const
+    {
+        return window_.data() + begin_;
+    }
+
+    const char *data_end() const
+    {
+        return window_.data() + end_;
+    }
+
+    // marks the part before position as scanned
+    void consume(const char *position)
+    {
+        begin_ = static_cast<std::size_t>(position - window_.data());
+    }
+
+    // reads more of the part after what hasn't been scanned or given to the parser yet,
+    // which moves it to the start of the window, returns false at the end of the part
+    bool fill()
+    {
+        if (begin_ != 0)
+        {
+            std::copy(window_.begin() + static_cast<std::ptrdiff_t>(begin_),
+                window_.begin() + static_cast<std::ptrdiff_t>(end_), window_.begin());
+            end_ -= begin_;
+            begin_ = 0;
+        }
+
+        if (end_ * 2 > window_.size())
+        {
+            window_.resize(window_.size() * 2);
+        }
+
+        const auto count = part_.sgetn(window_.data() + end_, static_cast<std::streamsize>(window_.size() - end_));
+
+        if (count <= 0)
+        {
+            return false;
+        }
+
+        end_ += static_cast<std::size_t>(count);
+
+        return true;
+    }
+
+    // gives the part from where scanning stopped to the parser
+    void release()
+    {
+        state_ = state::passthrough;
+    }
+
+    // gives the end tags of <sheetData> and <worksheet> to the parser instead of the rest of the part
+    void truncate()
+    {
+        state_ = state::truncated;
+    }
+
+private:
+    enum class state
+    {
+        head,
+        held,
+        passthrough,
+        truncated
+    };
+
+    virtual int_type underflow()
+    {
+        if (state_ == state::head)
+        {
+            underflow_head();
+        }
+        else if (state_ == state::held && spaces_.empty())
+        {
+            // the parser reads ahead of the <sheetData> start tag before the content is scanned
+            spaces_.assign(4096, ' ');
+            setg(&spaces_[0], &spaces_[0], &spaces_[0] + spaces_.size());
+        }
+        else if (state_ == state::truncated)
+        {
+            if (!end_tags_.empty())
+            {
+                return traits_type::eof();
+            }
+
+            end_tags_ = "</sheetData></worksheet>";
+            setg(&end_tags_[0], &end_tags_[0], &end_tags_[0] + end_tags_.size());
+        }
+        else
+        {
+            // also when the parser reads past the whitespace, the content wasn't scanned then
+            state_ = state::passthrough;
+
+            if (begin_ == end_ && !fill())
+            {
+                return traits_type::eof();
+            }
+
+            give(end_);
+        }
+
+        return gptr() == egptr() ? traits_type::eof() : traits_type::to_int_type(*gptr());
+    }
+
+    // gives the parser the part up to the end of the <sheetData> start tag
+    void underflow_head()
+    {
+        if (eback() == nullptr && (!fill() || !utf8()))
+        {
+            state_ = state::passthrough;
+            give(end_);
+
+            return;
+        }
+
+        while (true)
+        {
+            const auto begin = window_.data() + begin_;
+            const auto end = window_.data() + end_;
+            auto tag = std::find(begin, end, '<');
+
+            for (; tag != end && end - tag > 10; tag = std::find(tag + 1, end, '<'))
+            {
+                const auto next = tag[10];
+
+                if (tag[1] == '!')
+                {
+                    state_ = state::passthrough;
+                    give(end_);
+
+                    return;
+                }
+
+                if (!std::equal(tag + 1, tag + 10, "sheetData")
+                    || (next != '>' && next != '/' && next != ' ' && next != '\t' && next != '\r' && next != '\n'))
+                {
+                    continue;
+                }
+
+                const auto tag_end = std::find(tag, end, '>');
+
+                if (tag_end == end)
+                {
+                    break;
+                }
+
+                state_ = tag_end[-1] == '/' ? state::passthrough : state::held;
+                give(static_cast<std::size_t>(tag_end + 1 - window_.data()));
+
+                return;
+            }
+
+            // the part before a tag which isn't complete in the window yet
+            if (tag != begin)
+            {
+                give(static_cast<std::size_t>(tag - window_.data()));
+                return;
+            }
+
+            if (!fill())
+            {
+                state_ = state::passthrough;
+                give(end_);
+
+                return;
+            }
+        }
+    }
+
+    // the scanner reads UTF-8 only
+    bool utf8() const
+    {
+        const auto begin = window_.data();
+        const auto end = begin + end_;
+        const char declaration[] = "<?xml";
+
+        if (end_ < 5 || !std::equal(declaration, declaration + 5, begin))
+        {
+            return true;
+        }
+
+        const char declaration_end[] = "?>";
+        const char encoding_name[] = "encoding";
+        const char utf8_name[] = "UTF-8";
+        const char utf8_lower_name[] = "utf-8";
+        const auto close = std::search(begin, end, declaration_end, declaration_end + 2);
+        const auto encoding = std::search(begin, close, encoding_name, encoding_name + 8);
+
+        return close != end
+            && (encoding == close || std::search(encoding, close, utf8_name, utf8_name + 5) != close
+                || std::search(encoding, close, utf8_lower_name, utf8_lower_name + 5) != close);
+    }
+
+    // gives the parser the part read into the window up to offset
+    void give(std::size_t offset)
+    {
+        setg(window_.data() + begin_, window_.data() + begin_, window_.data() + offset);
+        begin_ = offset;
+    }
+
+    std::streambuf &part_;
+    std::vector<char> window_;
+    std::size_t begin_ = 0;
+    std::size_t end_ = 0;
+    state state_ = state::head;
+    std::string spaces_;
+    std::string end_tags_;
+};
+
+} // namespace detail
+} // namespace xlnt
+
 namespace {
 /// string_equal
 /// for comparison between std::string and string literals
@@ -76,7 +329,8 @@ inline bool string_equal(const std::string &lhs, const char (&rhs)[N])
 xml::qname &qn(const std::string &namespace_, const std::string &name)
 {
     using qname_map = std::unordered_map<std::string, xml::qname>;
-    static auto &memo = *new std::unordered_map<std::string, qname_map>();
+    // one memo per thread so that worksheets can be parsed concurrently
+    static thread_local std::unordered_map<std::string, qname_map> memo;
 
     auto &ns_memo = memo[namespace_];
 
@@ -247,8 +501,61 @@ xlnt::detail::Cell parse_cell(xlnt::row_t row_arg, xml::parser *parser)
     return c;
 }
 
-// <row> inside <sheetData> element
-std::pair<xlnt::row_properties, int> parse_row(xml::parser *parser, xlnt::detail::number_serialiser &converter, std::vector<xlnt::detail::Cell> &parsed_cells)
+// columns kept by load_options::worksheet_columns, indexed by column index
+// an empty mask keeps every column
+using column_mask = std::vector<bool>;
+
+// rows kept by load_options::worksheet_rows, first and last inclusive
+using row_range = std::pair<xlnt::row_t, xlnt::row_t>;
+
+const row_range all_rows(1, std::numeric_limits<xlnt::row_t>::max());
+
+// rows without a reference are kept like cells without one
+bool keep_row(xlnt::row_t row, const row_range &rows)
+{
+    return row == 0 || (row >= rows.first && row <= rows.second);
+}
+
+// true if the <c> element the parser is positioned on should be parsed
+bool keep_cell(xml::parser *parser, const column_mask &columns)
+{
+    const auto &attributes = parser->attribute_map();
+    const auto reference = attributes.find(xml::qname("r"));
+
+    if (reference == attributes.end())
+    {
+        return true;
+    }
+
+    const auto column = xlnt::detail::Cell_Reference(0, reference->second.value).column;
+
+    return column < columns.size() && columns[column];
+}
+
+// skips the remainder of an element whose start the parser has just read, up to and including its end
+void skip_element(xml::parser *parser)
+{
+    int level = 1;
+
+    while (level > 0)
+    {
+        switch (parser->next())
+        {
+        case xml::parser::start_element:
+            ++level;
+            break;
+        case xml::parser::end_element:
+            --level;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+// <row> inside <sheetData> element, added to sheet_data unless it is outside of rows
+void parse_row(xml::parser *parser, xlnt::detail::number_serialiser &converter,
+    const column_mask &columns, const row_range &rows, Sheet_Data &sheet_data)
 {
     std::pair<xlnt::row_properties, int> props;
     for (auto &attr : parser->attribute_map())
@@ -283,82 +590,865 @@ std::pair<xlnt::row_properties, int> parse_row(xml::parser *parser, xlnt::detail
         }
         else if (string_equal(attr.first.name(), "r"))
         {
-            props.second = static_cast<int>(strtol(attr.second.value.c_str(), nullptr, 10));
+            props.second = static_cast<int>(strtol(attr.second.value.c_str(), nullptr, 10));
+        }
+        else if (string_equal(attr.first.name(), "customHeight"))
+        {
+            props.first.custom_height = is_true(attr.second.value.c_str());
+        }
+    }
+
+    if (!keep_row(static_cast<xlnt::row_t>(props.second), rows))
+    {
+        skip_element(parser);
+        return;
+    }
+
+    auto &parsed_cells = sheet_data.parsed_cells;
+    int level = 1;
+    while (level > 0)
+    {
+        xml::parser::event_type e = parser->next();
+        switch (e)
+        {
+        case xml::parser::start_element: {
+            if (!columns.empty() && !keep_cell(parser, columns))
+            {
+                skip_element(parser);
+                break;
+            }
+            parsed_cells.push_back(parse_cell(static_cast<xlnt::row_t>(props.second), parser));
+            break;
+        }
+        case xml::parser::end_element: {
+            --level;
+            break;
+        }
+        case xml::parser::characters: {
+            // ignore whitespace
+            break;
+        }
+        case xml::parser::start_namespace_decl:
+        case xml::parser::start_attribute:
+        case xml::parser::end_namespace_decl:
+        case xml::parser::end_attribute:
+        case xml::parser::eof:
+        default: {
+            throw xlnt::exception("unexcpected XML parsing event");
+        }
+        }
+    }
+    sheet_data.parsed_rows.push_back(std::move(props));
+}
+
+// <sheetData> inside <worksheet> element
+// parsed rows and their cells are handed to sink in chunks of at least chunk_size cells
+// so that the whole sheet never has to be held in a Sheet_Data at once
+template <typename Sink>
+void parse_sheet_data(xml::parser *parser, xlnt::detail::number_serialiser &converter,
+    const column_mask &columns, const row_range &rows, std::size_t chunk_size, Sink sink)
+{
+    Sheet_Data sheet_data;
+    int level = 1; // nesting level
+        // 1 == <sheetData>
+        // 2 == <row>
+
+    while (level > 0)
+    {
+        xml::parser::event_type e = parser->next();
+        switch (e)
+        {
+        case xml::parser::start_element: {
+            parse_row(parser, converter, columns, rows, sheet_data);
+            if (sheet_data.parsed_cells.size() >= chunk_size)
+            {
+                sink(std::move(sheet_data));
+                sheet_data = Sheet_Data();
+            }
+            break;
+        }
+        case xml::parser::end_element: {
+            --level;
+            break;
+        }
+        case xml::parser::characters: {
+            // ignore, whitespace formatting normally
+            break;
+        }
+        case xml::parser::start_namespace_decl:
+        case xml::parser::start_attribute:
+        case xml::parser::end_namespace_decl:
+        case xml::parser::end_attribute:
+        case xml::parser::eof:
+        default: {
+            throw xlnt::exception("unexcpected XML parsing event");
+        }
+        }
+    }
+
+    if (!sheet_data.parsed_rows.empty())
+    {
+        sink(std::move(sheet_data));
+    }
+}
+
+template <size_t N>
+inline bool name_equal(const char *begin, const char *end, const char (&rhs)[N])
+{
+    return static_cast<size_t>(end - begin) == N - 1 && std::equal(begin, end, rhs);
+}
+
+/// <summary>
+/// Reads the rows of a <sheetData> element straight from the XML text for the
+/// common <row r=".."><c r=".." s=".." t=".."><v>..</v></c></row> form. The cells
+/// are identical to the ones parse_row builds from an xml::parser. Anything else,
+/// such as rich inline strings, comments or CDATA, makes scan_row return
+/// result::unusual so the rest of the element can be handed to an xml::parser.
+/// </summary>
+class sheet_data_scanner
+{
+public:
+    enum class result
+    {
+        row,
+        end,
+        unusual
+    };
+
+    sheet_data_scanner(const char *begin, const char *end)
+        : position_(begin),
+          end_(end)
+    {
+    }
+
+    // the start of the next row, or of the row that was unusual
+    const char *position() const
+    {
+        return position_;
+    }
+
+    // the reference of the last row read
+    xlnt::row_t row() const
+    {
+        return row_;
+    }
+
+    result scan_row(xlnt::detail::number_serialiser &converter, const column_mask &columns, const row_range &rows,
+        Sheet_Data &sheet_data)
+    {
+        const auto row_start = position_;
+        const auto rows_before = sheet_data.parsed_rows.size();
+        const auto cells_before = sheet_data.parsed_cells.size();
+
+        skip_whitespace();
+
+        if (end_tag("sheetData"))
+        {
+            return result::end;
+        }
+
+        if (read_row(converter, columns, rows, sheet_data))
+        {
+            return result::row;
+        }
+
+        position_ = row_start;
+        sheet_data.parsed_rows.resize(rows_before);
+        sheet_data.parsed_cells.resize(cells_before);
+
+        return result::unusual;
+    }
+
+private:
+    bool read_row(xlnt::detail::number_serialiser &converter, const column_mask &columns, const row_range &rows,
+        Sheet_Data &sheet_data)
+    {
+        if (!start_tag("row"))
+        {
+            return false;
+        }
+
+        std::pair<xlnt::row_properties, int> props;
+        bool empty = false;
+
+        auto row_attribute = [&](const char *name, const char *name_end, const char *value, const char *value_end) {
+            if (name_equal(name, name_end, "r"))
+            {
+                return read_integer(value, value_end, props.second);
+            }
+            if (name_equal(name, name_end, "spans"))
+            {
+                props.first.spans = std::string(value, value_end);
+            }
+            else if (name_equal(name, name_end, "dyDescent"))
+            {
+                props.first.dy_descent = converter.deserialise(std::string(value, value_end));
+            }
+            else if (name_equal(name, name_end, "ht"))
+            {
+                props.first.height = converter.deserialise(std::string(value, value_end));
+            }
+            else if (name_equal(name, name_end, "s"))
+            {
+                props.first.style = strtoul(std::string(value, value_end).c_str(), nullptr, 10);
+            }
+            else if (name_equal(name, name_end, "hidden"))
+            {
+                props.first.hidden = is_true(std::string(value, value_end));
+            }
+            else if (name_equal(name, name_end, "customFormat"))
+            {
+                props.first.custom_format = is_true(std::string(value, value_end));
+            }
+            else if (name_equal(name, name_end, "customHeight"))
+            {
+                props.first.custom_height = is_true(std::string(value, value_end));
+            }
+            return true;
+        };
+
+        if (!attributes(row_attribute, empty))
+        {
+            return false;
+        }
+
+        row_ = static_cast<xlnt::row_t>(props.second);
+
+        // there are no comments or CDATA sections in the buffer so the end tag can't be hidden
+        if (!keep_row(static_cast<xlnt::row_t>(props.second), rows))
+        {
+            if (empty)
+            {
+                return true;
+            }
+
+            const char row_end_tag[] = "</row";
+            position_ = std::search(position_, end_, row_end_tag, row_end_tag + 5);
+
+            return end_tag("row");
+        }
+
+        while (!empty)
+        {
+            skip_whitespace();
+
+            if (end_tag("row"))
+            {
+                break;
+            }
+
+            xlnt::detail::Cell cell;
+
+            if (!read_cell(static_cast<xlnt::row_t>(props.second), cell))
+            {
+                return false;
+            }
+
+            if (columns.empty() || (cell.ref.column < columns.size() && columns[cell.ref.column]) || !has_reference_)
+            {
+                sheet_data.parsed_cells.push_back(std::move(cell));
+            }
+        }
+
+        sheet_data.parsed_rows.emplace_back(std::move(props.first), static_cast<xlnt::row_t>(props.second));
+
+        return true;
+    }
+
+    bool read_cell(xlnt::row_t row, xlnt::detail::Cell &cell)
+    {
+        if (!start_tag("c"))
+        {
+            return false;
+        }
+
+        bool empty = false;
+        has_reference_ = false;
+
+        auto cell_attribute = [&](const char *name, const char *name_end, const char *value, const char *value_end) {
+            if (name_equal(name, name_end, "r"))
+            {
+                cell.ref = xlnt::detail::Cell_Reference(row, std::string(value, value_end));
+                has_reference_ = true;
+            }
+            else if (name_equal(name, name_end, "s"))
+            {
+                return read_integer(value, value_end, cell.style_index);
+            }
+            else if (name_equal(name, name_end, "t"))
+            {
+                cell.type = type_from_string(std::string(value, value_end));
+            }
+            else if (name_equal(name, name_end, "ph"))
+            {
+                cell.is_phonetic = is_true(std::string(value, value_end));
+            }
+            else if (name_equal(name, name_end, "cm"))
+            {
+                return read_integer(value, value_end, cell.cell_metatdata_idx);
+            }
+            return true;
+        };
+
+        if (!attributes(cell_attribute, empty))
+        {
+            return false;
+        }
+
+        while (!empty)
+        {
+            skip_whitespace();
+
+            if (end_tag("c"))
+            {
+                break;
+            }
+
+            if (start_tag("v"))
+            {
+                if (!simple_element("v", cell.value))
+                {
+                    return false;
+                }
+            }
+            else if (start_tag("f"))
+            {
+                if (!simple_element("f", cell.formula_string))
+                {
+                    return false;
+                }
+            }
+            else if (start_tag("is"))
+            {
+                if (!inline_string(cell.value))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // <is> containing only <t>
+    bool inline_string(std::string &value)
+    {
+        bool empty = false;
+
+        if (!attributes(ignore_attribute, empty))
+        {
+            return false;
+        }
+
+        while (!empty)
+        {
+            skip_whitespace();
+
+            if (end_tag("is"))
+            {
+                break;
+            }
+
+            if (!start_tag("t") || !simple_element("t", value))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // the attributes, text and end tag of an element whose name has just been read
+    template <size_t N>
+    bool simple_element(const char (&name)[N], std::string &value)
+    {
+        bool empty = false;
+
+        if (!attributes(ignore_attribute, empty))
+        {
+            return false;
+        }
+
+        return empty || (text(value) && end_tag(name));
+    }
+
+    static bool ignore_attribute(const char *, const char *, const char *, const char *)
+    {
+        return true;
+    }
+
+    // reads attributes up to and including the end of the start tag, calling handler
+    // with the local name and raw value of each one
+    template <typename Handler>
+    bool attributes(Handler handler, bool &empty)
+    {
+        while (true)
+        {
+            skip_whitespace();
+
+            if (position_ == end_)
+            {
+                return false;
+            }
+
+            if (*position_ == '>')
+            {
+                ++position_;
+                empty = false;
+
+                return true;
+            }
+
+            if (*position_ == '/')
+            {
+                if (end_ - position_ < 2 || position_[1] != '>')
+                {
+                    return false;
+                }
+
+                position_ += 2;
+                empty = true;
+
+                return true;
+            }
+
+            auto name = position_;
+
+            while (position_ != end_ && *position_ != '=' && !is_whitespace(*position_))
+            {
+                ++position_;
+            }
+
+            auto name_end = position_;
+            skip_whitespace();
+
+            if (position_ == end_ || *position_ != '=')
+            {
+                return false;
+            }
+
+            ++position_;
+            skip_whitespace();
+
+            if (position_ == end_ || (*position_ != '"' && *position_ != '\''))
+            {
+                return false;
+            }
+
+            const auto quote = *position_++;
+            auto value = position_;
+
+            while (position_ != end_ && *position_ != quote)
+            {
+                // values with references or whitespace that the XML parser would normalise
+                if (*position_ == '&' || *position_ == '<' || (is_whitespace(*position_) && *position_ != ' '))
+                {
+                    return false;
+                }
+
+                ++position_;
+            }
+
+            if (position_ == end_)
+            {
+                return false;
+            }
+
+            auto value_end = position_++;
+
+            // compare local names like the parser based path does
+            auto local_name = std::find(std::reverse_iterator<const char *>(name_end),
+                std::reverse_iterator<const char *>(name), ':').base();
+
+            if (!handler(local_name, name_end, value, value_end))
+            {
+                return false;
+            }
+        }
+    }
+
+    // character data up to the next tag with references resolved
+    bool text(std::string &value)
+    {
+        while (position_ != end_ && *position_ != '<')
+        {
+            auto run = position_;
+
+            while (position_ != end_ && *position_ != '<' && *position_ != '&' && *position_ != '\r')
+            {
+                ++position_;
+            }
+
+            value.append(run, position_);
+
+            if (position_ == end_ || *position_ == '<')
+            {
+                break;
+            }
+
+            if (*position_ == '\r' || !reference(value))
+            {
+                return false;
+            }
+        }
+
+        return position_ != end_;
+    }
+
+    // an entity or character reference starting at '&'
+    bool reference(std::string &value)
+    {
+        auto reference_end = std::find(position_, std::min(end_, position_ + 12), ';');
+
+        if (reference_end == end_ || *reference_end != ';')
+        {
+            return false;
+        }
+
+        const auto name = position_ + 1;
+        position_ = reference_end + 1;
+
+        if (name_equal(name, reference_end, "lt"))
+        {
+            value.push_back('<');
+        }
+        else if (name_equal(name, reference_end, "gt"))
+        {
+            value.push_back('>');
+        }
+        else if (name_equal(name, reference_end, "amp"))
+        {
+            value.push_back('&');
+        }
+        else if (name_equal(name, reference_end, "quot"))
+        {
+            value.push_back('"');
+        }
+        else if (name_equal(name, reference_end, "apos"))
+        {
+            value.push_back('\'');
+        }
+        else if (reference_end - name > 1 && *name == '#')
+        {
+            const auto hex = name[1] == 'x';
+            std::uint32_t code_point = 0;
+
+            for (auto digit = name + (hex ? 2 : 1); digit != reference_end; ++digit)
+            {
+                auto c = static_cast<unsigned char>(*digit);
+
+                if (c >= '0' && c <= '9')
+                {
+                    code_point = code_point * (hex ? 16 : 10) + (c - '0');
+                }
+                else if (hex && (c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+                {
+                    code_point = code_point * 16 + ((c | 0x20) - 'a' + 10);
+                }
+                else
+                {
+                    return false;
+                }
+            }
+
+            return append_utf8(code_point, value);
+        }
+        else
+        {
+            return false;
+        }
+
+        return true;
+    }
+
+    static bool append_utf8(std::uint32_t code_point, std::string &value)
+    {
+        if (code_point == 0 || code_point > 0x10ffff || (code_point >= 0xd800 && code_point <= 0xdfff))
+        {
+            return false;
+        }
+
+        if (code_point < 0x80)
+        {
+            value.push_back(static_cast<char>(code_point));
+        }
+        else if (code_point < 0x800)
+        {
+            value.push_back(static_cast<char>(0xc0 | (code_point >> 6)));
+            value.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+        }
+        else if (code_point < 0x10000)
+        {
+            value.push_back(static_cast<char>(0xe0 | (code_point >> 12)));
+            value.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+            value.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+        }
+        else
+        {
+            value.push_back(static_cast<char>(0xf0 | (code_point >> 18)));
+            value.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3f)));
+            value.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+            value.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+        }
+
+        return true;
+    }
+
+    // digits only, the values the XML parser based path would read with strtol
+    template <typename T>
+    static bool read_integer(const char *value, const char *value_end, T &result)
+    {
+        if (value == value_end || value_end - value > 9)
+        {
+            return false;
+        }
+
+        T number = 0;
+
+        for (; value != value_end; ++value)
+        {
+            if (*value < '0' || *value > '9')
+            {
+                return false;
+            }
+
+            number = static_cast<T>(number * 10 + (*value - '0'));
+        }
+
+        result = number;
+
+        return true;
+    }
+
+    // consumes "<name" if it is followed by the end of the name
+    template <size_t N>
+    bool start_tag(const char (&name)[N])
+    {
+        if (static_cast<size_t>(end_ - position_) < N + 1 || *position_ != '<'
+            || !std::equal(name, name + N - 1, position_ + 1))
+        {
+            return false;
+        }
+
+        const auto next = position_[N];
+
+        if (next != '>' && next != '/' && !is_whitespace(next))
+        {
+            return false;
+        }
+
+        position_ += N;
+
+        return true;
+    }
+
+    // consumes "</name>"
+    template <size_t N>
+    bool end_tag(const char (&name)[N])
+    {
+        if (static_cast<size_t>(end_ - position_) < N + 2 || position_[0] != '<' || position_[1] != '/'
+            || !std::equal(name, name + N - 1, position_ + 2))
+        {
+            return false;
+        }
+
+        auto after_name = position_ + N + 1;
+
+        while (after_name != end_ && is_whitespace(*after_name))
+        {
+            ++after_name;
+        }
+
+        if (after_name == end_ || *after_name != '>')
+        {
+            return false;
+        }
+
+        position_ = after_name + 1;
+
+        return true;
+    }
+
+    static bool is_whitespace(char c)
+    {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+    }
+
+    void skip_whitespace()
+    {
+        while (position_ != end_ && is_whitespace(*position_))
+        {
+            ++position_;
+        }
+    }
+
+    const char *position_;
+    const char *end_;
+    xlnt::row_t row_ = 0;
+    bool has_reference_ = false;
+};
+
+// true if the part from begin has the end of a row or of <sheetData>, so that a row the
+// scanner stopped at isn't only cut off by the end of the window
+bool has_row_end(const char *begin, const char *end)
+{
+    const char row_end_tag[] = "</row>";
+    const char sheet_data_end_tag[] = "</sheetData";
+
+    return std::search(begin, end, row_end_tag, row_end_tag + 6) != end
+        || std::search(begin, end, sheet_data_end_tag, sheet_data_end_tag + 11) != end;
+}
+
+// Parses the rows of the <sheetData> element whose content source holds back from the parser,
+// handing them to sink like parse_sheet_data. The rows are read by a sheet_data_scanner from the
+// window of source, which is refilled when a row doesn't fit in it. The row the scanner finds
+// unusual and the ones after it are given to the parser. The rest of the part is skipped once
+// a row after rows has been read.
+template <typename Sink>
+void scan_sheet_data(xlnt::detail::worksheet_part_streambuf &source, xlnt::detail::number_serialiser &converter,
+    const column_mask &columns, const row_range &rows, std::size_t chunk_size, Sink sink)
+{
+    Sheet_Data sheet_data;
+    auto result = sheet_data_scanner::result::row;
+    auto after_rows = false;
+
+    while (result == sheet_data_scanner::result::row && !after_rows)
+    {
+        sheet_data_scanner scanner(source.data(), source.data_end());
+        auto row_start = scanner.position();
+
+        while ((result = scanner.scan_row(converter, columns, rows, sheet_data)) == sheet_data_scanner::result::row)
+        {
+            row_start = scanner.position();
+
+            if (scanner.row() > rows.second)
+            {
+                after_rows = true;
+                break;
+            }
+
+            if (sheet_data.parsed_cells.size() >= chunk_size)
+            {
+                sink(std::move(sheet_data));
+                sheet_data = Sheet_Data();
+            }
         }
-        else if (string_equal(attr.first.name(), "customHeight"))
+
+        source.consume(row_start);
+
+        if (result == sheet_data_scanner::result::unusual && !has_row_end(source.data(), source.data_end())
+            && source.fill())
         {
-            props.first.custom_height = is_true(attr.second.value.c_str());
+            result = sheet_data_scanner::result::row;
         }
     }
 
-    int level = 1;
-    while (level > 0)
+    if (!sheet_data.parsed_rows.empty())
     {
-        xml::parser::event_type e = parser->next();
-        switch (e)
-        {
-        case xml::parser::start_element: {
-            parsed_cells.push_back(parse_cell(static_cast<xlnt::row_t>(props.second), parser));
-            break;
-        }
-        case xml::parser::end_element: {
-            --level;
-            break;
-        }
-        case xml::parser::characters: {
-            // ignore whitespace
-            break;
-        }
-        case xml::parser::start_namespace_decl:
-        case xml::parser::start_attribute:
-        case xml::parser::end_namespace_decl:
-        case xml::parser::end_attribute:
-        case xml::parser::eof:
-        default: {
-            throw xlnt::exception("unexcpected XML parsing event");
-        }
-        }
+        sink(std::move(sheet_data));
+    }
+
+    if (after_rows)
+    {
+        source.truncate();
+    }
+    else
+    {
+        source.release();
     }
-    return props;
 }
 
-// <sheetData> inside <worksheet> element
-Sheet_Data parse_sheet_data(xml::parser *parser, xlnt::detail::number_serialiser &converter)
+// Parses the <sheetData> element parser is positioned on. If source holds back the content of
+// the element from parser, the content is scanned from source first.
+template <typename Sink>
+void read_sheet_data(xml::parser *parser, xlnt::detail::worksheet_part_streambuf *source,
+    xlnt::detail::number_serialiser &converter, const column_mask &columns, const row_range &rows,
+    std::size_t chunk_size, Sink sink)
 {
-    Sheet_Data sheet_data;
-    int level = 1; // nesting level
-        // 1 == <sheetData>
-        // 2 == <row>
+    if (source != nullptr && source->sheet_data_held())
+    {
+        scan_sheet_data(*source, converter, columns, rows, chunk_size, sink);
+    }
 
-    while (level > 0)
+    parse_sheet_data(parser, converter, columns, rows, chunk_size, sink);
+}
+
+// number of cells parsed before they are handed over for construction
+const std::size_t sheet_data_chunk_size = 4096;
+
+// number of parsed chunks which may be waiting for construction when pipelined
+const std::size_t sheet_data_queue_capacity = 4;
+
+/// <summary>
+/// A bounded single producer, single consumer queue of parsed sheet data chunks
+/// used to overlap parsing <sheetData> with constructing cells.
+/// </summary>
+class sheet_data_queue
+{
+public:
+    // blocks while the queue is full, returns false if the consumer has gone away
+    bool push(Sheet_Data &&chunk)
     {
-        xml::parser::event_type e = parser->next();
-        switch (e)
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this]() { return chunks_.size() < sheet_data_queue_capacity || abandoned_; });
+
+        if (abandoned_)
         {
-        case xml::parser::start_element: {
-            sheet_data.parsed_rows.push_back(parse_row(parser, converter, sheet_data.parsed_cells));
-            break;
-        }
-        case xml::parser::end_element: {
-            --level;
-            break;
-        }
-        case xml::parser::characters: {
-            // ignore, whitespace formatting normally
-            break;
-        }
-        case xml::parser::start_namespace_decl:
-        case xml::parser::start_attribute:
-        case xml::parser::end_namespace_decl:
-        case xml::parser::end_attribute:
-        case xml::parser::eof:
-        default: {
-            throw xlnt::exception("unexcpected XML parsing event");
+            return false;
         }
+
+        chunks_.push_back(std::move(chunk));
+        not_empty_.notify_one();
+
+        return true;
+    }
+
+    // blocks while the queue is empty, returns false once it is closed and drained
+    bool pop(Sheet_Data &chunk)
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this]() { return !chunks_.empty() || closed_; });
+
+        if (chunks_.empty())
+        {
+            return false;
         }
+
+        chunk = std::move(chunks_.front());
+        chunks_.pop_front();
+        not_full_.notify_one();
+
+        return true;
     }
-    return sheet_data;
-}
+
+    // called by the producer when there is nothing more to push
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_one();
+    }
+
+    // called by the consumer when it stops popping early
+    void abandon()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        abandoned_ = true;
+        not_full_.notify_one();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+    std::deque<Sheet_Data> chunks_;
+    bool closed_ = false;
+    bool abandoned_ = false;
+};
 
 } // namespace
 
@@ -394,13 +1484,47 @@ xlsx_consumer::~xlsx_consumer()
 
 void xlsx_consumer::read(std::istream &source)
 {
+    if (options_.lazy_worksheets)
+    {
+        // the workbook keeps reading from the archive after source is gone
+        std::unique_ptr<std::stringstream> source_copy(new std::stringstream());
+        *source_copy << source.rdbuf();
+        read(std::move(source_copy), options_);
+
+        return;
+    }
+
     archive_.reset(new izstream(source));
+    archive_->buffer_size(options_.buffer_size);
+    populate_workbook(false);
+}
+
+void xlsx_consumer::read(std::unique_ptr<std::istream> &&source, const load_options &options)
+{
+    options_ = options;
+    archive_ = std::make_shared<izstream>(std::move(source));
+    archive_->buffer_size(options_.buffer_size);
+    populate_workbook(false);
+}
+
+void xlsx_consumer::read(std::shared_ptr<izstream> archive, const load_options &options)
+{
+    options_ = options;
+    archive_ = std::move(archive);
+    archive_->buffer_size(options_.buffer_size);
     populate_workbook(false);
 }
 
+void xlsx_consumer::read(std::istream &source, const load_options &options)
+{
+    options_ = options;
+    read(source);
+}
+
 void xlsx_consumer::open(std::istream &source)
 {
     archive_.reset(new izstream(source));
+    archive_->buffer_size(options_.buffer_size);
     populate_workbook(true);
 }
 
@@ -412,12 +1536,47 @@ cell xlsx_consumer::read_cell()
     }
 
     auto ws = worksheet(current_worksheet_);
+    auto row_index = row_t(0);
 
     if (in_element(qn("spreadsheetml", "sheetData")))
     {
         expect_start_element(qn("spreadsheetml", "row"), xml::content::complex); // CT_Row
-        auto row_index = static_cast<row_t>(std::stoul(parser().attribute("r")));
-        auto &row_properties = ws.row_properties(row_index);
+        row_index = static_cast<row_t>(std::stoul(parser().attribute("r")));
+
+        // rows before the range are skipped and reading stops at the first row after it
+        const auto kept_rows = options_.worksheet_rows.find(current_worksheet_->title_);
+
+        if (kept_rows != options_.worksheet_rows.end())
+        {
+            while (row_index < kept_rows->second.first)
+            {
+                skip_remaining_content(qn("spreadsheetml", "row"));
+                expect_end_element(qn("spreadsheetml", "row"));
+
+                if (!in_element(qn("spreadsheetml", "sheetData")))
+                {
+                    expect_end_element(qn("spreadsheetml", "sheetData"));
+                    return cell(nullptr);
+                }
+
+                expect_start_element(qn("spreadsheetml", "row"), xml::content::complex);
+                row_index = static_cast<row_t>(std::stoul(parser().attribute("r")));
+            }
+
+            if (row_index > kept_rows->second.second)
+            {
+                past_row_range_ = true;
+                return cell(nullptr);
+            }
+        }
+
+        // a streamed row only lives until the next row is read
+        if (streaming_)
+        {
+            streaming_row_properties_ = xlnt::row_properties();
+        }
+
+        auto &row_properties = streaming_ ? streaming_row_properties_ : ws.row_properties(row_index);
 
         if (parser().attribute_present("ht"))
         {
@@ -451,11 +1610,29 @@ cell xlsx_consumer::read_cell()
 
     if (!in_element(qn("spreadsheetml", "row")))
     {
+        // a row without cells which has just been started
+        if (row_index != 0)
+        {
+            end_row(row_index);
+        }
+
         return cell(nullptr);
     }
 
     expect_start_element(qn("spreadsheetml", "c"), xml::content::complex);
 
+    // a streamed cell is overwritten by the next call instead of being stored in the worksheet
+    if (streaming_)
+    {
+        // the text and formula of the last cell are kept by its worksheet
+        if (streaming_cell_->parent_ != nullptr)
+        {
+            streaming_cell_->clear_attributes();
+        }
+
+        *streaming_cell_ = detail::cell_impl();
+    }
+
     auto cell = streaming_
         ? xlnt::cell(streaming_cell_.get())
         : ws.cell(cell_reference(parser().attribute("r")));
@@ -474,7 +1651,17 @@ cell xlsx_consumer::read_cell()
 
     if (parser().attribute_present("s"))
     {
-        cell.format(target_.format(static_cast<std::size_t>(std::stoull(parser().attribute("s")))));
+        const auto format = target_.format(static_cast<std::size_t>(std::stoull(parser().attribute("s"))));
+
+        if (streaming_)
+        {
+            // not counted as a reference since the cell isn't kept
+            cell.d_->format_ = format.d_;
+        }
+        else
+        {
+            cell.format(format);
+        }
     }
 
     auto has_value = false;
@@ -524,7 +1711,15 @@ cell xlsx_consumer::read_cell()
 
     expect_end_element(qn("spreadsheetml", "c"));
 
-    if (has_formula && !has_shared_formula)
+    if (has_formula && !has_shared_formula && streaming_)
+    {
+        // cell::formula would register the calculation chain of the worksheet
+        if (!formula_value_string.empty())
+        {
+            cell.d_->formula(formula_value_string[0] == '=' ? formula_value_string.substr(1) : formula_value_string);
+        }
+    }
+    else if (has_formula && !has_shared_formula)
     {
         cell.formula(formula_value_string);
     }
@@ -533,12 +1728,12 @@ cell xlsx_consumer::read_cell()
     {
         if (type == "str")
         {
-            cell.d_->value_text_ = value_string;
+            cell.d_->text(value_string);
             cell.data_type(cell::type::formula_string);
         }
         else if (type == "inlineStr")
         {
-            cell.d_->value_text_ = value_string;
+            cell.d_->text(value_string);
             cell.data_type(cell::type::inline_string);
         }
         else if (type == "s")
@@ -562,15 +1757,76 @@ cell xlsx_consumer::read_cell()
 
     if (!in_element(qn("spreadsheetml", "row")))
     {
-        expect_end_element(qn("spreadsheetml", "row"));
+        end_row(reference.row());
+    }
+
+    return cell;
+}
+
+void xlsx_consumer::end_row(row_t row)
+{
+    expect_end_element(qn("spreadsheetml", "row"));
+    row_ended_ = true;
+
+    const auto kept_rows = options_.worksheet_rows.find(current_worksheet_->title_);
+
+    if (kept_rows != options_.worksheet_rows.end() && row >= kept_rows->second.second)
+    {
+        past_row_range_ = true;
+    }
+    else if (!in_element(qn("spreadsheetml", "sheetData")))
+    {
+        expect_end_element(qn("spreadsheetml", "sheetData"));
+    }
+}
+
+void xlsx_consumer::read_rows(std::size_t count, row_batch &batch)
+{
+    batch.clear();
+
+    while (batch.row_count < count && has_cell())
+    {
+        row_ended_ = false;
+        const auto cell = read_cell();
+
+        if (cell.d_ != nullptr)
+        {
+            const auto &impl = *cell.d_;
+            auto number = 0.0;
 
-        if (!in_element(qn("spreadsheetml", "sheetData")))
+            batch.rows.push_back(impl.row_);
+            batch.columns.push_back(impl.column_.index);
+            batch.types.push_back(impl.type_);
+
+            switch (impl.type_)
+            {
+            case cell::type::empty:
+                break;
+            case cell::type::boolean:
+            case cell::type::date:
+            case cell::type::number:
+                number = impl.value_numeric_;
+                break;
+            case cell::type::shared_string:
+                number = impl.value_numeric_;
+                batch.string_data.append(target_.shared_strings(static_cast<std::size_t>(impl.value_numeric_)).plain_text());
+                break;
+            case cell::type::error:
+            case cell::type::formula_string:
+            case cell::type::inline_string:
+                batch.string_data.append(impl.text().plain_text());
+                break;
+            }
+
+            batch.numbers.push_back(number);
+            batch.string_offsets.push_back(batch.string_data.size());
+        }
+
+        if (row_ended_)
         {
-            expect_end_element(qn("spreadsheetml", "sheetData"));
+            ++batch.row_count;
         }
     }
-
-    return cell;
 }
 
 void xlsx_consumer::read_worksheet(const std::string &rel_id)
@@ -591,6 +1847,8 @@ std::string xlsx_consumer::read_worksheet_begin(const std::string &rel_id)
         streaming_cell_.reset(new detail::cell_impl());
     }
 
+    past_row_range_ = false;
+
     auto title = std::find_if(target_.d_->sheet_title_rel_id_map_.begin(),
         target_.d_->sheet_title_rel_id_map_.end(),
         [&](const std::pair<std::string, std::string> &p) {
@@ -903,66 +2161,154 @@ void xlsx_consumer::read_worksheet_sheetdata()
     {
         return;
     }
-    Sheet_Data ws_data = parse_sheet_data(parser_, converter_);
-    // NOTE: parse->construct are seperated here and could easily be threaded
-    // with a SPSC queue for what is likely to be an easy performance win
-    for (auto &row : ws_data.parsed_rows)
-    {
-        current_worksheet_->row_properties_.emplace(row.second, std::move(row.first));
-    }
-    auto impl = detail::cell_impl();
-    for (Cell &cell : ws_data.parsed_cells)
+
+    column_mask columns;
+    const auto kept_columns = options_.worksheet_columns.find(current_worksheet_->title_);
+
+    if (kept_columns != options_.worksheet_columns.end())
     {
-        impl.parent_ = current_worksheet_;
-        impl.column_ = cell.ref.column;
-        impl.row_ = cell.ref.row;
-        detail::cell_impl *ws_cell_impl = &current_worksheet_->cell_map_.emplace(cell_reference(impl.column_, impl.row_), std::move(impl)).first->second;
-        if (cell.style_index != -1)
-        {
-            ws_cell_impl->format_ = target_.format(static_cast<size_t>(cell.style_index)).d_;
-        }
-        if (cell.cell_metatdata_idx != -1)
+        for (const auto &column : kept_columns->second)
         {
+            if (column.index >= columns.size())
+            {
+                columns.resize(column.index + 1, false);
+            }
+
+            columns[column.index] = true;
         }
-        ws_cell_impl->phonetics_visible_ = cell.is_phonetic;
-        if (!cell.formula_string.empty())
+
+        // keeping no columns is distinct from the empty mask which keeps them all
+        columns.resize(std::max(columns.size(), std::size_t(1)), false);
+    }
+
+    const auto kept_rows = options_.worksheet_rows.find(current_worksheet_->title_);
+    const auto &rows = kept_rows == options_.worksheet_rows.end() ? all_rows : kept_rows->second;
+
+    const auto &date_format_ids = target_.d_->date_format_ids_;
+
+    auto construct = [this, &date_format_ids](Sheet_Data &&ws_data) {
+        for (auto &row : ws_data.parsed_rows)
         {
-            ws_cell_impl->formula_ = cell.formula_string[0] == '=' ? cell.formula_string.substr(1) : std::move(cell.formula_string);
+            current_worksheet_->row_properties_.emplace(row.second, std::move(row.first));
         }
-        if (!cell.value.empty())
+        auto impl = detail::cell_impl();
+        for (Cell &cell : ws_data.parsed_cells)
         {
-            ws_cell_impl->type_ = cell.type;
-            switch (cell.type)
+            impl.parent_ = current_worksheet_;
+            impl.column_ = cell.ref.column;
+            impl.row_ = cell.ref.row;
+            detail::cell_impl *ws_cell_impl = current_worksheet_->cell_map_.emplace(std::move(impl)).first;
+            if (cell.style_index != -1 && !options_.values_only)
             {
-            case cell::type::boolean: {
-                ws_cell_impl->value_numeric_ = is_true(cell.value) ? 1.0 : 0.0;
-                break;
-            }
-            case cell::type::empty:
-            case cell::type::number:
-            case cell::type::date: {
-                ws_cell_impl->value_numeric_ = converter_.deserialise(cell.value);
-                break;
-            }
-            case cell::type::shared_string: {
-                ws_cell_impl->value_numeric_ = static_cast<double>(strtol(cell.value.c_str(), nullptr, 10));
-                break;
+                ws_cell_impl->format_ = target_.format(static_cast<size_t>(cell.style_index)).d_;
             }
-            case cell::type::inline_string: {
-                ws_cell_impl->value_text_ = std::move(cell.value);
-                break;
+            else if (cell.style_index != -1 && static_cast<std::size_t>(cell.style_index) < date_format_ids.size()
+                && date_format_ids[static_cast<std::size_t>(cell.style_index)].is_set())
+            {
+                ws_cell_impl->format_ = target_.format(date_format_ids[static_cast<std::size_t>(cell.style_index)].get()).d_;
             }
-            case cell::type::formula_string: {
-                ws_cell_impl->value_text_ = std::move(cell.value);
-                break;
+            if (cell.cell_metatdata_idx != -1)
+            {
             }
-            case cell::type::error: {
-                ws_cell_impl->value_text_.plain_text(cell.value, false);
-                break;
+            ws_cell_impl->phonetics_visible_ = cell.is_phonetic;
+            if (!cell.formula_string.empty())
+            {
+                ws_cell_impl->formula(cell.formula_string[0] == '=' ? cell.formula_string.substr(1) : std::move(cell.formula_string));
             }
+            if (!cell.value.empty())
+            {
+                ws_cell_impl->type_ = cell.type;
+                switch (cell.type)
+                {
+                case cell::type::boolean: {
+                    ws_cell_impl->value_numeric_ = is_true(cell.value) ? 1.0 : 0.0;
+                    break;
+                }
+                case cell::type::empty:
+                case cell::type::number:
+                case cell::type::date: {
+                    ws_cell_impl->value_numeric_ = converter_.deserialise(cell.value);
+                    break;
+                }
+                case cell::type::shared_string: {
+                    ws_cell_impl->value_numeric_ = static_cast<double>(strtol(cell.value.c_str(), nullptr, 10));
+                    break;
+                }
+                case cell::type::inline_string: {
+                    ws_cell_impl->text(std::move(cell.value));
+                    break;
+                }
+                case cell::type::formula_string: {
+                    ws_cell_impl->text(std::move(cell.value));
+                    break;
+                }
+                case cell::type::error: {
+                    rich_text text;
+                    text.plain_text(cell.value, false);
+                    ws_cell_impl->text(std::move(text));
+                    break;
+                }
+                }
             }
         }
+    };
+
+    if (!options_.pipeline_sheet_data)
+    {
+        read_sheet_data(parser_, worksheet_part_, converter_, columns, rows, sheet_data_chunk_size, construct);
+        stack_.pop_back();
+
+        return;
+    }
+
+    // parse on a second thread while cells are constructed on this one,
+    // the parser is not touched by this thread again until the producer is joined
+    sheet_data_queue queue;
+    std::exception_ptr parse_error;
+
+    std::thread producer([this, &columns, &rows, &queue, &parse_error]() {
+        try
+        {
+            number_serialiser converter;
+            read_sheet_data(parser_, worksheet_part_, converter, columns, rows, sheet_data_chunk_size,
+                [&queue](Sheet_Data &&chunk) {
+                    if (!queue.push(std::move(chunk)))
+                    {
+                        throw xlnt::exception("sheet data construction was abandoned");
+                    }
+                });
+        }
+        catch (...)
+        {
+            parse_error = std::current_exception();
+        }
+
+        queue.close();
+    });
+
+    try
+    {
+        Sheet_Data chunk;
+
+        while (queue.pop(chunk))
+        {
+            construct(std::move(chunk));
+        }
+    }
+    catch (...)
+    {
+        queue.abandon();
+        producer.join();
+        throw;
     }
+
+    producer.join();
+
+    if (parse_error)
+    {
+        std::rethrow_exception(parse_error);
+    }
+
     stack_.pop_back();
 }
 
@@ -975,7 +2321,20 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
     path sheet_path(sheet_rel.source().path().parent().append(sheet_rel.target().path()));
     auto hyperlinks = manifest.relationships(sheet_path, xlnt::relationship_type::hyperlink);
 
-    auto ws = worksheet(current_worksheet_);
+    auto ws = worksheet(current_worksheet_);
+
+    if (streaming_ && streaming_cell_->parent_ != nullptr)
+    {
+        streaming_cell_->clear_attributes();
+        *streaming_cell_ = detail::cell_impl();
+    }
+
+    // the rest of the part may not have been read
+    if (options_.worksheet_rows.count(ws.title()) > 0)
+    {
+        stack_.pop_back();
+        return ws;
+    }
 
     while (in_element(qn("spreadsheetml", "worksheet")))
     {
@@ -1101,7 +2460,7 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
                         hyperlink.tooltip = parser().attribute("tooltip");
                     }
 
-                    cell.d_->hyperlink_ = hyperlink;
+                    cell.d_->reset_hyperlink() = hyperlink;
                 }
 
                 expect_end_element(qn("spreadsheetml", "hyperlink"));
@@ -1360,6 +2719,11 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
 
     expect_end_element(qn("spreadsheetml", "worksheet"));
 
+    if (options_.values_only)
+    {
+        return ws;
+    }
+
     if (manifest.has_relationship(sheet_path, xlnt::relationship_type::comments))
     {
         auto comments_part = manifest.canonicalize({workbook_rel, sheet_rel,
@@ -1411,8 +2775,9 @@ xml::parser &xlsx_consumer::parser()
 
 bool xlsx_consumer::has_cell()
 {
-    return in_element(qn("spreadsheetml", "row"))
-        || in_element(qn("spreadsheetml", "sheetData"));
+    return !past_row_range_
+        && (in_element(qn("spreadsheetml", "row"))
+            || in_element(qn("spreadsheetml", "sheetData")));
 }
 
 std::vector<relationship> xlsx_consumer::read_relationships(const path &part)
@@ -1462,6 +2827,18 @@ void xlsx_consumer::read_part(const std::vector<relationship> &rel_chain)
     const auto part_path = manifest.canonicalize(rel_chain);
     auto part_streambuf = archive_->open(part_path);
     std::istream part_stream(part_streambuf.get());
+
+    // the cells of a worksheet part are scanned without the xml::parser where possible
+    std::unique_ptr<worksheet_part_streambuf> worksheet_streambuf;
+
+    if (rel_chain.back().type() == relationship_type::worksheet && !streaming_)
+    {
+        worksheet_streambuf.reset(new worksheet_part_streambuf(*part_streambuf, options_.buffer_size));
+        part_stream.rdbuf(worksheet_streambuf.get());
+    }
+
+    worksheet_part_ = worksheet_streambuf.get();
+
     xml::parser parser(part_stream, part_path.string());
     parser_ = &parser;
 
@@ -1512,7 +2889,14 @@ void xlsx_consumer::read_part(const std::vector<relationship> &rel_chain)
         break;
 
     case relationship_type::stylesheet:
-        read_stylesheet();
+        if (options_.values_only)
+        {
+            read_stylesheet_date_formats();
+        }
+        else
+        {
+            read_stylesheet();
+        }
         break;
 
     case relationship_type::theme:
@@ -1590,6 +2974,7 @@ void xlsx_consumer::read_part(const std::vector<relationship> &rel_chain)
     }
 
     parser_ = nullptr;
+    worksheet_part_ = nullptr;
 }
 
 void xlsx_consumer::populate_workbook(bool streaming)
@@ -1597,6 +2982,7 @@ void xlsx_consumer::populate_workbook(bool streaming)
     streaming_ = streaming;
 
     target_.clear();
+    target_.d_->load_options_ = options_;
 
     read_content_types();
     const auto root_path = path("/");
@@ -1614,6 +3000,11 @@ void xlsx_consumer::populate_workbook(bool streaming)
             continue;
         }
 
+        if (package_rel.type() == relationship_type::thumbnail && options_.values_only)
+        {
+            continue;
+        }
+
         read_part({package_rel});
     }
 
@@ -1627,6 +3018,58 @@ void xlsx_consumer::populate_workbook(bool streaming)
 
     read_part({manifest().relationship(root_path,
         relationship_type::office_document)});
+
+    // parts that weren't read, such as excluded worksheets, aren't kept by a lazily loaded workbook
+    archive_->stop_prefetch();
+
+    // the worksheets were changed only by being read
+    for (auto &worksheet : target_.d_->worksheets_)
+    {
+        worksheet.modified_ = false;
+    }
+}
+
+void xlsx_consumer::prefetch_parts()
+{
+    if (!manifest().has_relationship(path("/"), relationship_type::office_document))
+    {
+        return;
+    }
+
+    const auto workbook_rel = manifest().relationship(path("/"), relationship_type::office_document);
+    const auto workbook_path = workbook_rel.target().path();
+    std::vector<path> parts;
+
+    for (auto type : {relationship_type::shared_string_table, relationship_type::stylesheet, relationship_type::theme})
+    {
+        if (manifest().has_relationship(workbook_path, type) && !(type == relationship_type::theme && options_.values_only))
+        {
+            parts.push_back(manifest().canonicalize({workbook_rel, manifest().relationship(workbook_path, type)}));
+        }
+    }
+
+    // worksheets read partially, after loading or not at all would only be inflated for nothing
+    if (!options_.lazy_worksheets && options_.worksheet_rows.empty())
+    {
+        for (const auto &worksheet_rel : manifest().relationships(workbook_path, relationship_type::worksheet))
+        {
+            const auto title = std::find_if(target_.d_->sheet_title_rel_id_map_.begin(),
+                target_.d_->sheet_title_rel_id_map_.end(),
+                [&](const std::pair<std::string, std::string> &p) {
+                    return p.second == worksheet_rel.id();
+                });
+
+            if (!options_.worksheet_titles.empty()
+                && (title == target_.d_->sheet_title_rel_id_map_.end() || options_.worksheet_titles.count(title->first) == 0))
+            {
+                continue;
+            }
+
+            parts.push_back(manifest().canonicalize({workbook_rel, worksheet_rel}));
+        }
+    }
+
+    archive_->prefetch(parts, options_.prefetch_threads, options_.prefetch_memory);
 }
 
 // Package Parts
@@ -1985,6 +3428,12 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
 
     expect_end_element(qn("workbook", "workbook"));
 
+    // the titles of the worksheets are known from here on
+    if (!streaming_ && options_.prefetch_threads > 0)
+    {
+        prefetch_parts();
+    }
+
     auto workbook_rel = manifest().relationship(path("/"), relationship_type::office_document);
     auto workbook_path = workbook_rel.target().path();
 
@@ -2002,13 +3451,16 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
                 relationship_type::stylesheet)});
     }
 
-    if (manifest().has_relationship(workbook_path, relationship_type::theme))
+    if (manifest().has_relationship(workbook_path, relationship_type::theme) && !options_.values_only)
     {
         read_part({workbook_rel,
             manifest().relationship(workbook_path,
                 relationship_type::theme)});
     }
 
+    std::vector<std::pair<relationship, worksheet_impl *>> worksheets;
+    std::vector<worksheet_impl *> excluded_worksheets;
+
     for (auto worksheet_rel : manifest().relationships(workbook_path, relationship_type::worksheet))
     {
         auto title = std::find_if(target_.d_->sheet_title_rel_id_map_.begin(),
@@ -2029,13 +3481,272 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
 
         current_worksheet_ = &*target_.d_->worksheets_.emplace(insertion_iter, &target_, id, title);
 
-        if (!streaming_)
+        if (streaming_)
+        {
+            continue;
+        }
+
+        if (options_.worksheet_titles.empty() || options_.worksheet_titles.count(title) > 0)
+        {
+            worksheets.emplace_back(worksheet_rel, current_worksheet_);
+        }
+        else
+        {
+            excluded_worksheets.push_back(current_worksheet_);
+        }
+    }
+
+    read_worksheets(worksheets);
+
+    if (options_.copy_unmodified_worksheets && !options_.lazy_worksheets && !options_.values_only
+        && excluded_worksheets.empty())
+    {
+        read_raw_worksheets(worksheets);
+    }
+
+    // removed once the others have been read because removal renumbers relationship ids
+    for (auto excluded_worksheet : excluded_worksheets)
+    {
+        target_.remove_sheet(worksheet(excluded_worksheet));
+    }
+}
+
+void xlsx_consumer::read_raw_worksheets(const std::vector<std::pair<relationship, worksheet_impl *>> &worksheets)
+{
+    // copied worksheets refer to shared strings and cell formats by their index in the package
+    if (shared_strings_renumbered_ || !target_.d_->stylesheet_.is_set())
+    {
+        return;
+    }
+
+    const auto workbook_rel = manifest().relationship(path("/"), relationship_type::office_document);
+
+    for (const auto &worksheet : worksheets)
+    {
+        const auto &title = worksheet.second->title_;
+
+        if (options_.worksheet_columns.count(title) > 0 || options_.worksheet_rows.count(title) > 0)
+        {
+            continue;
+        }
+
+        // the copy is only usable if it's written where xlsx_producer would write the worksheet
+        const auto &worksheet_rel = worksheet.first;
+        const auto part_path = manifest().canonicalize({workbook_rel, worksheet_rel});
+
+        if (part_path.string() != worksheet_rel.source().path().parent().append(worksheet_rel.target().path()).string())
+        {
+            continue;
+        }
+
+        auto raw_parts = std::make_shared<zentries>();
+
+        if (read_raw_parts({workbook_rel, worksheet_rel}, *raw_parts))
+        {
+            worksheet.second->raw_parts_ = raw_parts;
+            worksheet.second->raw_parts_id_ = worksheet.second->id_;
+        }
+    }
+
+    auto &workbook = *target_.d_;
+    workbook.raw_formats_.clear();
+
+    for (const auto &format : workbook.stylesheet_.get().format_impls)
+    {
+        workbook.raw_formats_.push_back(&format);
+    }
+
+    workbook.raw_active_tab_ = workbook.view_.is_set() ? workbook.view_.get().active_tab : optional<std::size_t>();
+}
+
+bool xlsx_consumer::read_raw_parts(const std::vector<relationship> &rel_chain, zentries &entries)
+{
+    const auto part = manifest().canonicalize(rel_chain);
+
+    if (!archive_->has_file(part))
+    {
+        return false;
+    }
+
+    const auto copied = [&entries](const path &file) {
+        return std::any_of(entries.headers.begin(), entries.headers.end(),
+            [&file](const zheader &header) { return header.filename == file.string(); });
+    };
+
+    if (copied(part))
+    {
+        return true;
+    }
+
+    archive_->copy(part, entries);
+
+    const auto part_rels_path = part.parent().append("_rels").append(part.filename() + ".rels").relative_to(path("/"));
+
+    if (!archive_->has_file(part_rels_path))
+    {
+        return true;
+    }
+
+    archive_->copy(part_rels_path, entries);
+
+    for (const auto &child_rel : manifest().relationships(part))
+    {
+        if (child_rel.target_mode() == target_mode::external) continue;
+
+        auto child_rel_chain = rel_chain;
+        child_rel_chain.push_back(child_rel);
+
+        if (!read_raw_parts(child_rel_chain, entries))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void xlsx_consumer::read_worksheets(const std::vector<std::pair<relationship, worksheet_impl *>> &worksheets)
+{
+    if (options_.lazy_worksheets)
+    {
+        for (const auto &worksheet : worksheets)
+        {
+            worksheet.second->unread_ = true;
+        }
+
+        if (!worksheets.empty())
+        {
+            target_.d_->archive_ = archive_;
+        }
+
+        return;
+    }
+
+    const auto thread_count = std::min(options_.worksheet_threads, worksheets.size());
+
+    if (thread_count <= 1)
+    {
+        const auto workbook_rel = manifest().relationship(path("/"), relationship_type::office_document);
+
+        for (const auto &worksheet : worksheets)
+        {
+            current_worksheet_ = worksheet.second;
+            read_part({workbook_rel, worksheet.first});
+        }
+
+        return;
+    }
+
+    // part paths are resolved up front because the manifest is modified while reading
+    // the end of a worksheet (hyperlinks, comments) and must not be read concurrently
+    const auto workbook_rel = manifest().relationship(path("/"), relationship_type::office_document);
+    std::vector<path> part_paths;
+
+    for (const auto &worksheet : worksheets)
+    {
+        part_paths.push_back(manifest().canonicalize({workbook_rel, worksheet.first}));
+    }
+
+    // cell data is parsed concurrently, everything else which might touch the workbook
+    // is done while holding workbook_mutex
+    std::mutex workbook_mutex;
+    std::atomic<std::size_t> next_worksheet(0);
+    std::vector<std::exception_ptr> errors(thread_count);
+
+    auto read_worksheets_worker = [&](std::size_t thread_index) {
+        try
+        {
+            xlsx_consumer consumer(target_);
+            consumer.archive_ = archive_;
+            consumer.options_ = options_;
+
+            for (auto i = next_worksheet++; i < worksheets.size(); i = next_worksheet++)
+            {
+                const auto &rel_id = worksheets[i].first.id();
+                consumer.current_worksheet_ = worksheets[i].second;
+
+                auto part_streambuf = archive_->open(part_paths[i]);
+                worksheet_part_streambuf worksheet_streambuf(*part_streambuf, options_.buffer_size);
+                std::istream part_stream(&worksheet_streambuf);
+                xml::parser parser(part_stream, part_paths[i].string());
+
+                consumer.parser_ = &parser;
+                consumer.worksheet_part_ = &worksheet_streambuf;
+                consumer.stack_.clear();
+
+                {
+                    std::lock_guard<std::mutex> lock(workbook_mutex);
+                    consumer.read_worksheet_begin(rel_id);
+                }
+
+                consumer.read_worksheet_sheetdata();
+
+                {
+                    std::lock_guard<std::mutex> lock(workbook_mutex);
+                    consumer.read_worksheet_end(rel_id);
+                }
+
+                consumer.parser_ = nullptr;
+                consumer.worksheet_part_ = nullptr;
+            }
+        }
+        catch (...)
+        {
+            errors[thread_index] = std::current_exception();
+            next_worksheet = worksheets.size();
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 1; i < thread_count; ++i)
+    {
+        threads.emplace_back(read_worksheets_worker, i);
+    }
+
+    read_worksheets_worker(0);
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (const auto &error : errors)
+    {
+        if (error)
         {
-            read_part({workbook_rel, worksheet_rel});
+            std::rethrow_exception(error);
         }
     }
 }
 
+void xlsx_consumer::read_unread_worksheet(worksheet_impl &worksheet)
+{
+    archive_ = target_.d_->archive_;
+    options_ = target_.d_->load_options_;
+    options_.lazy_worksheets = false;
+
+    // cleared first so that worksheet accessors used while reading don't recurse
+    worksheet.unread_ = false;
+
+    // relationship ids are renumbered as worksheets are added or removed so the
+    // current one is looked up by title
+    const auto workbook_rel = manifest().relationship(path("/"), relationship_type::office_document);
+    const auto &rel_id = target_.d_->sheet_title_rel_id_map_.at(worksheet.title_);
+    const auto worksheet_rel = manifest().relationship(workbook_rel.target().path(), rel_id);
+
+    current_worksheet_ = &worksheet;
+    read_part({workbook_rel, worksheet_rel});
+
+    auto &worksheets = target_.d_->worksheets_;
+
+    if (std::none_of(worksheets.begin(), worksheets.end(),
+            [](const worksheet_impl &impl) { return impl.unread_; }))
+    {
+        target_.d_->archive_.reset();
+    }
+}
+
 // Write Workbook Relationship Target Parts
 
 void xlsx_consumer::read_calculation_chain()
@@ -2088,7 +3799,12 @@ void xlsx_consumer::read_shared_string_table()
     {
         expect_start_element(qn("spreadsheetml", "si"), xml::content::complex);
         auto rt = read_rich_text(qn("spreadsheetml", "si"));
-        target_.add_shared_string(rt);
+        const auto expected_index = target_.shared_strings().size();
+
+        if (target_.add_shared_string(rt) != expected_index)
+        {
+            shared_strings_renumbered_ = true;
+        }
         expect_end_element(qn("spreadsheetml", "si"));
     }
 
@@ -2785,6 +4501,108 @@ void xlsx_consumer::read_stylesheet()
     }
 }
 
+void xlsx_consumer::read_stylesheet_date_formats()
+{
+    target_.impl().stylesheet_ = detail::stylesheet();
+    auto &stylesheet = target_.impl().stylesheet_.get();
+
+    std::vector<number_format> custom_number_formats;
+    std::vector<std::size_t> record_number_format_ids;
+
+    expect_start_element(qn("spreadsheetml", "styleSheet"), xml::content::complex);
+    skip_attributes({qn("mc", "Ignorable")});
+
+    while (in_element(qn("spreadsheetml", "styleSheet")))
+    {
+        auto current_style_element = expect_start_element(xml::content::complex);
+
+        if (current_style_element == qn("spreadsheetml", "numFmts"))
+        {
+            skip_attributes();
+
+            while (in_element(qn("spreadsheetml", "numFmts")))
+            {
+                expect_start_element(qn("spreadsheetml", "numFmt"), xml::content::simple);
+
+                xlnt::number_format nf;
+                nf.format_string(parser().attribute("formatCode"));
+                nf.id(parser().attribute<std::size_t>("numFmtId"));
+                custom_number_formats.push_back(nf);
+
+                expect_end_element(qn("spreadsheetml", "numFmt"));
+            }
+        }
+        else if (current_style_element == qn("spreadsheetml", "cellXfs"))
+        {
+            skip_attributes();
+
+            while (in_element(qn("spreadsheetml", "cellXfs")))
+            {
+                expect_start_element(qn("spreadsheetml", "xf"), xml::content::complex);
+
+                record_number_format_ids.push_back(parser().attribute_present("numFmtId")
+                        ? parser().attribute<std::size_t>("numFmtId")
+                        : 0);
+
+                skip_remaining_content(qn("spreadsheetml", "xf"));
+                expect_end_element(qn("spreadsheetml", "xf"));
+            }
+        }
+        else
+        {
+            skip_remaining_content(current_style_element);
+        }
+
+        expect_end_element(current_style_element);
+    }
+
+    expect_end_element(qn("spreadsheetml", "styleSheet"));
+
+    // one format for each date or time number format which is used by a record
+    auto &date_format_ids = target_.d_->date_format_ids_;
+    std::unordered_map<std::size_t, optional<std::size_t>> number_format_formats;
+
+    for (auto number_format_id : record_number_format_ids)
+    {
+        auto match = number_format_formats.find(number_format_id);
+
+        if (match == number_format_formats.end())
+        {
+            auto custom = std::find_if(custom_number_formats.begin(), custom_number_formats.end(),
+                [=](const number_format &nf) { return nf.id() == number_format_id; });
+            optional<std::size_t> format_id;
+
+            if (custom != custom_number_formats.end() && custom->is_date_format())
+            {
+                stylesheet.number_formats.push_back(*custom);
+                format_id = stylesheet.format_impls.size();
+            }
+            else if (custom == custom_number_formats.end()
+                && number_format::is_builtin_format(number_format_id)
+                && number_format::from_builtin_id(number_format_id).is_date_format())
+            {
+                format_id = stylesheet.format_impls.size();
+            }
+
+            if (format_id.is_set())
+            {
+                stylesheet.format_impls.push_back(format_impl());
+                auto &new_format = stylesheet.format_impls.back();
+
+                new_format.id = format_id.get();
+                new_format.parent = &stylesheet;
+                new_format.references = 1;
+                new_format.number_format_id = number_format_id;
+                new_format.number_format_applied = true;
+            }
+
+            match = number_format_formats.emplace(number_format_id, format_id).first;
+        }
+
+        date_format_ids.push_back(match->second);
+    }
+}
+
 void xlsx_consumer::read_theme()
 {
     auto workbook_rel = manifest().relationship(path("/"),
@@ -34,13 +34,18 @@
 
 #include <detail/external/include_libstudxml.hpp>
 #include <detail/serialization/zstream.hpp>
+#include <xlnt/cell/index_types.hpp>
 #include <xlnt/utils/numeric.hpp>
+#include <xlnt/utils/optional.hpp>
+#include <xlnt/workbook/load_options.hpp>
+#include <xlnt/worksheet/row_properties.hpp>
 
 namespace xlnt {
 
 class cell;
 class color;
 class rich_text;
+class row_batch;
 class manifest;
 template<typename T>
 class optional;
@@ -54,8 +59,10 @@ class worksheet;
 namespace detail {
 
 class izstream;
+class worksheet_part_streambuf;
 struct cell_impl;
 struct worksheet_impl;
+struct zentries;
 
 /// <summary>
 /// Handles writing a workbook into an XLSX file.
@@ -69,8 +76,29 @@ public:
 
 	void read(std::istream &source);
 
+	void read(std::istream &source, const load_options &options);
+
 	void read(std::istream &source, const std::string &password);
 
+    /// <summary>
+    /// Reads the package from source, which is kept open by the workbook if
+    /// options.lazy_worksheets is set.
+    /// </summary>
+    void read(std::unique_ptr<std::istream> &&source, const load_options &options);
+
+    /// <summary>
+    /// Reads the package from an archive that has already been opened, such as one
+    /// over a mapped file, which is kept by the workbook if options.lazy_worksheets is set.
+    /// </summary>
+    void read(std::shared_ptr<izstream> archive, const load_options &options);
+
+    /// <summary>
+    /// Reads a worksheet that was skipped by a load with load_options::lazy_worksheets
+    /// from the archive kept by the destination workbook. The archive is released
+    /// once no unread worksheets remain.
+    /// </summary>
+    void read_unread_worksheet(worksheet_impl &worksheet);
+
 private:
     friend class xlnt::streaming_workbook_reader;
 
@@ -85,6 +113,12 @@ private:
     /// </summary>
     cell read_cell();
 
+    /// <summary>
+    /// Reads the cells of the next count rows of the current worksheet into batch,
+    /// replacing its previous contents.
+    /// </summary>
+    void read_rows(std::size_t count, row_batch &batch);
+
 	/// <summary>
 	/// Read all the files needed from the XLSX archive and initialize all of
 	/// the data in the workbook to match.
@@ -178,6 +212,12 @@ private:
 	/// </summary>
 	void read_stylesheet();
 
+	/// <summary>
+	/// Reads only the date and time number formats of xl/styles.xml into
+	/// target_'s date_format_ids_ for load_options::values_only.
+	/// </summary>
+	void read_stylesheet_date_formats();
+
 	/// <summary>
 	/// xl/theme/theme1.xml
 	/// </summary>
@@ -213,11 +253,44 @@ private:
     /// </summary>
     void read_worksheet_sheetdata();
 
+    /// <summary>
+    /// Reads the end of the current row and, if it is the last one, of <sheetData>.
+    /// </summary>
+    void end_row(row_t row);
+
     /// <summary>
     /// xl/sheets/*.xml
     /// </summary>
     worksheet read_worksheet_end(const std::string &rel_id);
 
+    /// <summary>
+    /// Starts inflating the workbook parts read after the workbook itself, the shared strings,
+    /// stylesheet, theme and worksheets in the order they're read, on options_.prefetch_threads
+    /// background threads (see izstream::prefetch). Called once the workbook part has been
+    /// read so that worksheets left out by options_.worksheet_titles are skipped.
+    /// </summary>
+    void prefetch_parts();
+
+    /// <summary>
+    /// Reads each of the given worksheet parts into its worksheet_impl using
+    /// options_.worksheet_threads threads, each with its own xlsx_consumer.
+    /// If options_.lazy_worksheets is set, the worksheets are only marked as unread.
+    /// </summary>
+    void read_worksheets(const std::vector<std::pair<relationship, worksheet_impl *>> &worksheets);
+
+    /// <summary>
+    /// Copies the compressed parts of each of the given worksheets into its worksheet_impl
+    /// for workbook::save to write unchanged (see load_options::copy_unmodified_worksheets).
+    /// </summary>
+    void read_raw_worksheets(const std::vector<std::pair<relationship, worksheet_impl *>> &worksheets);
+
+    /// <summary>
+    /// Copies the compressed part the last relationship of rel_chain targets, its relationships
+    /// and, recursively, the internal parts they target into entries. Returns false if any of
+    /// these parts is missing from the package.
+    /// </summary>
+    bool read_raw_parts(const std::vector<relationship> &rel_chain, zentries &entries);
+
 	// Sheet Relationship Target Parts
 
 	/// <summary>
@@ -380,7 +453,12 @@ private:
 	/// <summary>
 	/// The ZIP file containing the files that make up the OOXML package.
 	/// </summary>
-	std::unique_ptr<izstream> archive_;
+	std::shared_ptr<izstream> archive_;
+
+	/// <summary>
+	/// Options controlling which parts are read and how.
+	/// </summary>
+	load_options options_;
 
 	/// <summary>
 	/// Map of sheet titles to relationship IDs.
@@ -411,8 +489,35 @@ private:
 
     bool streaming_ = false;
 
+    /// <summary>
+    /// True if the shared string table had duplicates, which are merged so the indices
+    /// of the strings that follow them no longer match the package.
+    /// </summary>
+    bool shared_strings_renumbered_ = false;
+
     std::unique_ptr<detail::cell_impl> streaming_cell_;
 
+    /// <summary>
+    /// The properties of the row containing streaming_cell_.
+    /// </summary>
+    row_properties streaming_row_properties_;
+
+    /// <summary>
+    /// True once read_cell has found a row after the row range of the current worksheet.
+    /// </summary>
+    bool past_row_range_ = false;
+
+    /// <summary>
+    /// Set by read_cell when it has read the end of a row.
+    /// </summary>
+    bool row_ended_ = false;
+
+    /// <summary>
+    /// The worksheet part read by parser_, whose <sheetData> content is held back from
+    /// the parser to be scanned by read_worksheet_sheetdata, or nullptr.
+    /// </summary>
+    worksheet_part_streambuf *worksheet_part_ = nullptr;
+
     detail::cell_impl *current_cell_;
 
     detail::worksheet_impl *current_worksheet_;
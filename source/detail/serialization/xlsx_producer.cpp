@@ -21,9 +21,14 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <exception>
+#include <iterator>
 #include <numeric> // for std::accumulate
 #include <string>
+#include <thread>
 #include <unordered_set>
 
 #include <xlnt/cell/cell.hpp>
@@ -88,14 +93,27 @@ xlsx_producer::xlsx_producer(const workbook &target)
 
 xlsx_producer::~xlsx_producer()
 {
-    end_part();
+    // a part or archive which wasn't finished, such as one being written by a streaming
+    // writer or when writing failed, is finished by its destructor, which doesn't throw
+    current_part_serializer_.reset();
+    current_part_streambuf_.reset();
     archive_.reset();
 }
 
 void xlsx_producer::write(std::ostream &destination)
 {
     archive_.reset(new ozstream(destination));
+    archive_->buffer_size(options_.buffer_size);
+    archive_->compression_threads(options_.compression_threads);
+    archive_->zip64(options_.zip64);
     populate_archive(false);
+    archive_->finish();
+}
+
+void xlsx_producer::write(std::ostream &destination, const save_options &options)
+{
+    options_ = options;
+    write(destination);
 }
 
 void xlsx_producer::open(std::ostream &destination)
@@ -124,6 +142,8 @@ void xlsx_producer::populate_archive(bool streaming)
 {
     streaming_ = streaming;
 
+    copy_raw_worksheets_ = !streaming_ && raw_worksheets_copyable();
+
     write_content_types();
 
     const auto root_rels = source_.manifest().relationships(path("/"));
@@ -173,17 +193,29 @@ void xlsx_producer::end_part()
         current_part_serializer_.reset();
     }
 
-    current_part_streambuf_.reset();
+    if (current_part_streambuf_)
+    {
+        // so that errors compressing or writing the end of the part are thrown
+        auto part_streambuf = std::move(current_part_streambuf_);
+        archive_->finish(part_streambuf);
+    }
 }
 
 void xlsx_producer::begin_part(const path &part)
 {
     end_part();
-    current_part_streambuf_ = archive_->open(part);
+    current_part_streambuf_ = archive_->open(part, compression_level(part));
     current_part_stream_.rdbuf(current_part_streambuf_.get());
     current_part_serializer_.reset(new xml::serializer(current_part_stream_, part.string()));
 }
 
+int xlsx_producer::compression_level(const path &part) const
+{
+    const auto level = options_.part_compression_levels.find(part.string());
+
+    return level != options_.part_compression_levels.end() ? level->second : options_.compression_level;
+}
+
 // Package Parts
 
 void xlsx_producer::write_content_types()
@@ -666,10 +698,42 @@ void xlsx_producer::write_workbook(const relationship &rel)
     auto workbook_rels = source_.manifest().relationships(rel.target().path());
     write_relationships(workbook_rels, rel.target().path());
 
+    // with more than one thread, worksheets are compressed up front and copied
+    // into the package below in place of being written there
+    std::vector<relationship> worksheet_rels;
+
+    if (!streaming_ && options_.worksheet_threads > 1)
+    {
+        std::copy_if(workbook_rels.begin(), workbook_rels.end(), std::back_inserter(worksheet_rels),
+            [this](const relationship &r) {
+                return r.type() == relationship_type::worksheet && raw_worksheet(r) == nullptr;
+            });
+    }
+
+    auto worksheet_entries = write_worksheets(worksheet_rels);
+    auto next_worksheet_entries = worksheet_entries.begin();
+
     for (const auto &child_rel : workbook_rels)
     {
         if (child_rel.type() == relationship_type::calculation_chain) continue;
 
+        if (child_rel.type() == relationship_type::worksheet)
+        {
+            if (auto raw_entries = raw_worksheet(child_rel))
+            {
+                end_part();
+                archive_->append(*raw_entries);
+                continue;
+            }
+        }
+
+        if (child_rel.type() == relationship_type::worksheet && next_worksheet_entries != worksheet_entries.end())
+        {
+            end_part();
+            archive_->append(*next_worksheet_entries++);
+            continue;
+        }
+
         path archive_path(child_rel.source().path().parent().append(child_rel.target().path()));
         begin_part(archive_path);
 
@@ -917,29 +981,18 @@ void xlsx_producer::write_shared_string_table(const relationship & /*rel*/)
     write_start_element(xmlns, "sst");
     write_namespace(xmlns, "");
 
-    // todo: is there a more elegant way to get this number?
+    // count is the number of cells referencing the table, so visit each stored
+    // cell once rather than every reference in the worksheet dimension
     std::size_t string_count = 0;
 
     for (const auto ws : source_)
     {
-        auto dimension = ws.calculate_dimension();
-        auto current_cell = dimension.top_left();
-
-        while (current_cell.row() <= dimension.bottom_right().row())
+        for (const auto &cell : ws.d_->cell_map_)
         {
-            while (current_cell.column() <= dimension.bottom_right().column())
+            if (cell.type_ == cell_type::shared_string)
             {
-                auto c_iter = ws.d_->cell_map_.find(current_cell);
-                if (c_iter != ws.d_->cell_map_.end() && c_iter->second.type_ == cell_type::shared_string)
-                {
-                    ++string_count;
-                }
-
-                current_cell.column_index(current_cell.column_index() + 1);
+                ++string_count;
             }
-
-            current_cell.row(current_cell.row() + 1);
-            current_cell.column_index(dimension.top_left().column_index());
         }
     }
 
@@ -2454,63 +2507,79 @@ void xlsx_producer::write_worksheet(const relationship &rel)
     std::vector<cell_reference> cells_with_comments;
 
     write_start_element(xmlns, "sheetData");
-    auto first_row = ws.lowest_row_or_props();
-    auto last_row = ws.highest_row_or_props();
+
+    // the cells are visited in row-major order once instead of looking up every reference in
+    // the dimension so that sparse worksheets are written in time proportional to their cells
+    std::vector<detail::cell_impl *> sorted_cells;
+    sorted_cells.reserve(ws.d_->cell_map_.size());
+
+    for (auto &cell : ws.d_->cell_map_)
+    {
+        if (!cell.is_garbage_collectible())
+        {
+            sorted_cells.push_back(&cell);
+        }
+    }
+
+    std::vector<row_t> property_rows;
+    property_rows.reserve(ws.d_->row_properties_.size());
+
+    for (const auto &props : ws.d_->row_properties_)
+    {
+        property_rows.push_back(props.first);
+    }
+
+    std::sort(property_rows.begin(), property_rows.end());
+
+    auto next_cell = sorted_cells.begin();
+    auto next_property_row = property_rows.begin();
+    auto block = row_t(0);
     auto first_block_column = constants::max_column();
     auto last_block_column = constants::min_column();
 
-    for (auto row = first_row; row <= last_row; ++row)
+    while (next_cell != sorted_cells.end() || next_property_row != property_rows.end())
     {
-        bool any_non_null = false;
-        auto first_check_row = row;
-        auto last_check_row = row;
-        auto first_row_in_block = row == first_row || row % 16 == 1;
+        auto row = next_property_row == property_rows.end() ? (*next_cell)->row_ : *next_property_row;
 
-        // See note for CT_Row, span attribute about block optimization
-        if (first_row_in_block)
+        if (next_cell != sorted_cells.end())
         {
-            // reset block column range
-            first_block_column = constants::max_column();
-            last_block_column = constants::min_column();
-
-            first_check_row = row;
-            // round up to the next multiple of 16
-            last_check_row = ((row / 16) + 1) * 16;
+            row = std::min(row, (*next_cell)->row_);
         }
 
-        for (auto check_row = first_check_row; check_row <= last_check_row; ++check_row)
+        if (next_property_row != property_rows.end() && *next_property_row == row)
         {
-            for (auto column = dimension.top_left().column(); column <= dimension.bottom_right().column(); ++column)
-            {
-                auto ref = cell_reference(column, check_row);
-                auto cell = ws.d_->cell_map_.find(ref);
-                if (cell == ws.d_->cell_map_.end())
-                {
-                    continue;
-                }
-                if (cell->second.is_garbage_collectible())
-                {
-                    continue;
-                }
+            ++next_property_row;
+        }
 
-                first_block_column = std::min(first_block_column, cell->second.column_);
-                last_block_column = std::max(last_block_column, cell->second.column_);
+        // See note for CT_Row, span attribute about block optimization
+        if ((row - 1) / 16 + 1 != block)
+        {
+            // reset block column range to the columns of the cells in the 16 rows of this block
+            block = (row - 1) / 16 + 1;
+            first_block_column = constants::max_column();
+            last_block_column = constants::min_column();
 
-                if (row == check_row)
-                {
-                    any_non_null = true;
-                }
+            for (auto block_cell = next_cell; block_cell != sorted_cells.end() && ((*block_cell)->row_ - 1) / 16 + 1 == block; ++block_cell)
+            {
+                first_block_column = std::min(first_block_column, (*block_cell)->column_);
+                last_block_column = std::max(last_block_column, (*block_cell)->column_);
             }
         }
 
+        const auto any_non_null = next_cell != sorted_cells.end() && (*next_cell)->row_ == row;
+
         if (!any_non_null && !ws.has_row_properties(row)) continue;
 
         write_start_element(xmlns, "row");
         write_attribute("r", row);
 
-        auto span_string = std::to_string(first_block_column.index) + ":"
-            + std::to_string(last_block_column.index);
-        write_attribute("spans", span_string);
+        // a block of rows with properties but no cells has no spans
+        if (first_block_column <= last_block_column)
+        {
+            auto span_string = std::to_string(first_block_column.index) + ":"
+                + std::to_string(last_block_column.index);
+            write_attribute("spans", span_string);
+        }
 
         if (ws.has_row_properties(row))
         {
@@ -2549,13 +2618,9 @@ void xlsx_producer::write_worksheet(const relationship &rel)
 
         if (any_non_null)
         {
-            for (auto column = dimension.top_left().column(); column <= dimension.bottom_right().column(); ++column)
+            for (; next_cell != sorted_cells.end() && (*next_cell)->row_ == row; ++next_cell)
             {
-                if (!ws.has_cell(cell_reference(column, row))) continue;
-
-                auto cell = ws.cell(cell_reference(column, row));
-
-                if (cell.garbage_collectible()) continue;
+                auto cell = xlnt::cell(*next_cell);
 
                 // record data about the cell needed later
 
@@ -3050,6 +3115,123 @@ void xlsx_producer::write_worksheet(const relationship &rel)
     }
 }
 
+std::vector<zentries> xlsx_producer::write_worksheets(const std::vector<relationship> &worksheet_rels)
+{
+    std::vector<zentries> entries(worksheet_rels.size());
+    const auto thread_count = std::min(options_.worksheet_threads, worksheet_rels.size());
+
+    if (thread_count == 0)
+    {
+        return entries;
+    }
+
+    // each worksheet is written by its own producer into its own entries, the
+    // workbook is only read
+    std::atomic<std::size_t> next_worksheet(0);
+    std::vector<std::exception_ptr> errors(thread_count);
+
+    auto write_worksheets_worker = [&](std::size_t thread_index) {
+        try
+        {
+            for (auto i = next_worksheet++; i < worksheet_rels.size(); i = next_worksheet++)
+            {
+                const auto &worksheet_rel = worksheet_rels[i];
+                xlsx_producer producer(source_);
+                producer.options_ = options_;
+                producer.archive_.reset(new ozstream(entries[i]));
+                producer.archive_->buffer_size(options_.buffer_size);
+                producer.archive_->compression_threads(options_.compression_threads);
+                producer.archive_->zip64(options_.zip64);
+                producer.begin_part(worksheet_rel.source().path().parent().append(worksheet_rel.target().path()));
+                producer.write_worksheet(worksheet_rel);
+                producer.end_part();
+                producer.archive_->finish();
+            }
+        }
+        catch (...)
+        {
+            errors[thread_index] = std::current_exception();
+            next_worksheet = worksheet_rels.size();
+        }
+    };
+
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 1; i < thread_count; ++i)
+    {
+        threads.emplace_back(write_worksheets_worker, i);
+    }
+
+    write_worksheets_worker(0);
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (const auto &error : errors)
+    {
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    return entries;
+}
+
+bool xlsx_producer::raw_worksheets_copyable() const
+{
+    const auto &workbook = *source_.d_;
+
+    if (!workbook.stylesheet_.is_set() || workbook.raw_formats_.empty())
+    {
+        return false;
+    }
+
+    // the loaded worksheets refer to cell formats by index and are marked as selected
+    // if they were the active tab, so neither may have changed since
+    const auto &formats = workbook.stylesheet_.get().format_impls;
+    const auto active_tab = workbook.view_.is_set() ? workbook.view_.get().active_tab : optional<std::size_t>();
+
+    return formats.size() >= workbook.raw_formats_.size()
+        && std::equal(workbook.raw_formats_.begin(), workbook.raw_formats_.end(), formats.begin(),
+            [](const format_impl *loaded, const format_impl &current) { return loaded == &current; })
+        && active_tab == workbook.raw_active_tab_;
+}
+
+const zentries *xlsx_producer::raw_worksheet(const relationship &rel) const
+{
+    if (!copy_raw_worksheets_)
+    {
+        return nullptr;
+    }
+
+    auto title = std::find_if(source_.d_->sheet_title_rel_id_map_.begin(), source_.d_->sheet_title_rel_id_map_.end(),
+        [&](const std::pair<std::string, std::string> &p) {
+            return p.second == rel.id();
+        });
+
+    if (title == source_.d_->sheet_title_rel_id_map_.end())
+    {
+        return nullptr;
+    }
+
+    // a worksheet is only written by the producer once it's been decided that it isn't copied,
+    // so its modified_ flag can't have been set by writing it
+    auto match = std::find_if(source_.d_->worksheets_.begin(), source_.d_->worksheets_.end(),
+        [&](const worksheet_impl &worksheet) { return worksheet.title_ == title->first; });
+
+    if (match == source_.d_->worksheets_.end() || !match->raw_parts_ || match->modified_
+        || match->raw_parts_id_ != match->id_
+        || match->raw_parts_->headers.front().filename != rel.source().path().parent().append(rel.target().path()).string())
+    {
+        return nullptr;
+    }
+
+    return match->raw_parts_.get();
+}
+
 // Sheet Relationship Target Parts
 
 void xlsx_producer::write_comments(const relationship & /*rel*/, worksheet ws, const std::vector<cell_reference> &cells)
@@ -3298,7 +3480,7 @@ void xlsx_producer::write_image(const path &image_path)
     end_part();
 
     vector_istreambuf buffer(source_.d_->images_.at(image_path.string()));
-    auto image_streambuf = archive_->open(image_path);
+    auto image_streambuf = archive_->open(image_path, compression_level(image_path));
     std::ostream(image_streambuf.get()) << &buffer;
 }
 
@@ -26,10 +26,13 @@
 #include <cstdint>
 #include <iostream>
 #include <memory>
+#include <string>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include <xlnt/utils/numeric.hpp>
+#include <xlnt/workbook/save_options.hpp>
 #include <detail/constants.hpp>
 #include <detail/external/include_libstudxml.hpp>
 
@@ -56,6 +59,7 @@ class worksheet;
 namespace detail {
 
 class ozstream;
+struct zentries;
 struct cell_impl;
 struct worksheet_impl;
 
@@ -73,6 +77,8 @@ public:
 
     void write(std::ostream &destination, const std::string &password);
 
+    void write(std::ostream &destination, const save_options &options);
+
 private:
     friend class xlnt::streaming_workbook_writer;
 
@@ -89,6 +95,11 @@ private:
 	void populate_archive(bool streaming);
 
     void begin_part(const path &part);
+
+    /// <summary>
+    /// Returns the compression level options_ gives for the part.
+    /// </summary>
+    int compression_level(const path &part) const;
     void end_part();
 
 	// Package Parts
@@ -122,6 +133,26 @@ private:
 	void write_dialogsheet(const relationship &rel);
 	void write_worksheet(const relationship &rel);
 
+    /// <summary>
+    /// Serializes and compresses the worksheets with the given relationships on
+    /// up to options_.worksheet_threads threads, returning the compressed parts
+    /// of each worksheet in the same order.
+    /// </summary>
+    std::vector<zentries> write_worksheets(const std::vector<relationship> &worksheet_rels);
+
+    /// <summary>
+    /// Returns true if the cell formats and the active tab of the workbook haven't
+    /// changed since it was loaded, so that the loaded parts of unmodified worksheets
+    /// can be copied into the package as they are (see load_options::copy_unmodified_worksheets).
+    /// </summary>
+    bool raw_worksheets_copyable() const;
+
+    /// <summary>
+    /// Returns the loaded parts of the worksheet with the given relationship, or
+    /// nullptr if it has to be written.
+    /// </summary>
+    const zentries *raw_worksheet(const relationship &rel) const;
+
 	// Sheet Relationship Target Parts
 
 	void write_comments(const relationship &rel, worksheet ws, const std::vector<cell_reference> &cells);
@@ -220,6 +251,13 @@ private:
 
     bool streaming_ = false;
 
+    save_options options_;
+
+    /// <summary>
+    /// True if unmodified worksheets are copied into the package as they were loaded.
+    /// </summary>
+    bool copy_raw_worksheets_ = false;
+
     std::unique_ptr<detail::cell_impl> streaming_cell_;
 
     detail::cell_impl *current_cell_;
@@ -36,16 +36,23 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <fstream>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <iterator> // for std::back_inserter
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <miniz.h>
 
 #include <xlnt/utils/exceptions.hpp>
+#include <detail/serialization/crc32.hpp>
+#include <detail/serialization/mapped_file.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/zstream.hpp>
 
@@ -66,6 +73,66 @@ void write_int(std::ostream &stream, T value)
     stream.write(reinterpret_cast<char *>(&value), sizeof(T));
 }
 
+const std::uint64_t zip64_limit = 0xffffffff;
+const std::uint16_t zip64_extra_id = 0x0001;
+const std::uint16_t zip64_version = 45;
+
+// Replaces the sizes and offset of header which don't fit 32 bits, and so are
+// 0xffffffff, with their 64-bit values from the ZIP64 extra field. These appear
+// in the extra field in this order, but only if the 32-bit field is 0xffffffff.
+void read_zip64_extra(xlnt::detail::zheader &header, const bool global)
+{
+    const auto &extra = header.extra;
+    std::size_t position = 0;
+
+    const auto read_extra = [&extra](std::size_t offset, std::size_t size) {
+        std::uint64_t value = 0;
+
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            value |= static_cast<std::uint64_t>(extra[offset + i]) << (8 * i);
+        }
+
+        return value;
+    };
+
+    while (position + 4 <= extra.size())
+    {
+        const auto id = static_cast<std::uint16_t>(read_extra(position, 2));
+        const auto size = static_cast<std::size_t>(read_extra(position + 2, 2));
+        position += 4;
+
+        if (position + size > extra.size())
+        {
+            break;
+        }
+
+        if (id == zip64_extra_id)
+        {
+            auto field = position;
+            const auto end = position + size;
+
+            for (auto value : {&header.uncompressed_size, &header.compressed_size, &header.header_offset})
+            {
+                if ((value == &header.header_offset && !global) || *value != zip64_limit)
+                {
+                    continue;
+                }
+
+                if (field + 8 > end)
+                {
+                    throw xlnt::exception("invalid ZIP64 extra field");
+                }
+
+                *value = read_extra(field, 8);
+                field += 8;
+            }
+        }
+
+        position += size;
+    }
+}
+
 xlnt::detail::zheader read_header(std::istream &istream, const bool global)
 {
     xlnt::detail::zheader header;
@@ -123,31 +190,58 @@ xlnt::detail::zheader read_header(std::istream &istream, const bool global)
         istream.read(&header.comment[0], comment_length);
     }
 
+    read_zip64_extra(header, global);
+
     return header;
 }
 
-void write_header(const xlnt::detail::zheader &header, std::ostream &ostream, const bool global)
+// Writes header as the local header of a file, or as its central header if global
+// is true. Sizes and the offset which don't fit 32 bits, or all of them if zip64 is
+// true, are written as 0xffffffff followed by a ZIP64 extra field with their values.
+// A local header with a ZIP64 extra field always has both sizes in it.
+void write_header(const xlnt::detail::zheader &header, std::ostream &ostream, const bool global, const bool zip64 = false)
 {
+    std::vector<std::uint64_t> zip64_values;
+
+    const auto sizes_zip64 = zip64 || header.uncompressed_size >= zip64_limit || header.compressed_size >= zip64_limit;
+
+    if (global)
+    {
+        if (zip64 || header.uncompressed_size >= zip64_limit) zip64_values.push_back(header.uncompressed_size);
+        if (zip64 || header.compressed_size >= zip64_limit) zip64_values.push_back(header.compressed_size);
+        if (zip64 || header.header_offset >= zip64_limit) zip64_values.push_back(header.header_offset);
+    }
+    else if (sizes_zip64)
+    {
+        zip64_values.push_back(header.uncompressed_size);
+        zip64_values.push_back(header.compressed_size);
+    }
+
+    const auto field = [&](std::uint64_t value) {
+        const auto in_extra = global ? zip64 || value >= zip64_limit : sizes_zip64;
+        return static_cast<std::uint32_t>(in_extra ? zip64_limit : value);
+    };
+
     if (global)
     {
         write_int(ostream, static_cast<std::uint32_t>(0x02014b50)); // header sig
-        write_int(ostream, static_cast<std::uint16_t>(20)); // version made by
+        write_int(ostream, static_cast<std::uint16_t>(zip64_values.empty() ? 20 : zip64_version)); // version made by
     }
     else
     {
         write_int(ostream, static_cast<std::uint32_t>(0x04034b50));
     }
 
-    write_int(ostream, header.version);
+    write_int(ostream, zip64_values.empty() ? header.version : std::max(header.version, zip64_version));
     write_int(ostream, header.flags);
     write_int(ostream, header.compression_type);
     write_int(ostream, header.stamp_date);
     write_int(ostream, header.stamp_time);
     write_int(ostream, header.crc);
-    write_int(ostream, header.compressed_size);
-    write_int(ostream, header.uncompressed_size);
+    write_int(ostream, field(header.compressed_size));
+    write_int(ostream, field(header.uncompressed_size));
     write_int(ostream, static_cast<std::uint16_t>(header.filename.length()));
-    write_int(ostream, static_cast<std::uint16_t>(0)); // extra lengthx
+    write_int(ostream, static_cast<std::uint16_t>(zip64_values.empty() ? 0 : 4 + 8 * zip64_values.size())); // extra length
 
     if (global)
     {
@@ -155,13 +249,217 @@ void write_header(const xlnt::detail::zheader &header, std::ostream &ostream, co
         write_int(ostream, static_cast<std::uint16_t>(0)); // disk# start
         write_int(ostream, static_cast<std::uint16_t>(0)); // internal file
         write_int(ostream, static_cast<std::uint32_t>(0)); // ext final
-        write_int(ostream, static_cast<std::uint32_t>(header.header_offset)); // rel offset
+        write_int(ostream, field(header.header_offset)); // rel offset
     }
 
     for (auto c : header.filename)
     {
         write_int(ostream, c);
     }
+
+    if (!zip64_values.empty())
+    {
+        write_int(ostream, zip64_extra_id);
+        write_int(ostream, static_cast<std::uint16_t>(8 * zip64_values.size()));
+
+        for (auto value : zip64_values)
+        {
+            write_int(ostream, value);
+        }
+    }
+}
+
+// Writes the local header of a file before its data. A file followed by a data descriptor
+// always has a ZIP64 extra field, as streaming readers expect 64-bit sizes in the data
+// descriptor only then, and zip64 is set to true for it.
+void start_local_header(xlnt::detail::zheader &header, std::ostream &ostream, bool &zip64)
+{
+    if ((header.flags & 0x08) != 0)
+    {
+        zip64 = true;
+    }
+
+    header.header_offset = static_cast<std::uint64_t>(ostream.tellp());
+    write_header(header, ostream, false, zip64);
+}
+
+// Completes the local header written by start_local_header once the data of the file
+// has been written. The data descriptor is written if there is one, otherwise the
+// header is written again with the crc and sizes. A file too large for the sizes of a
+// local header written without a ZIP64 extra field gets a data descriptor instead.
+void finish_local_header(xlnt::detail::zheader &header, std::ostream &ostream, const bool zip64)
+{
+    const auto large = header.compressed_size >= zip64_limit || header.uncompressed_size >= zip64_limit;
+    const auto final_position = ostream.tellp();
+
+    if ((header.flags & 0x08) == 0 && large && !zip64)
+    {
+        header.flags |= 0x08;
+
+        auto local_header = header;
+        local_header.crc = 0;
+        local_header.compressed_size = 0;
+        local_header.uncompressed_size = 0;
+
+        ostream.seekp(static_cast<std::streamoff>(header.header_offset));
+        write_header(local_header, ostream, false);
+        ostream.seekp(final_position);
+    }
+
+    if (large || zip64)
+    {
+        header.version = std::max(header.version, zip64_version);
+    }
+
+    if ((header.flags & 0x08) != 0)
+    {
+        write_int(ostream, static_cast<std::uint32_t>(0x08074b50));
+        write_int(ostream, header.crc);
+        write_int(ostream, header.compressed_size);
+        write_int(ostream, header.uncompressed_size);
+
+        return;
+    }
+
+    ostream.seekp(static_cast<std::streamoff>(header.header_offset));
+    write_header(header, ostream, false, zip64);
+    ostream.seekp(final_position);
+}
+
+// Forwards everything written to it to another streambuf and counts the bytes,
+// so that the position of a stream which can't seek is still known.
+class counting_streambuf : public std::streambuf
+{
+public:
+    counting_streambuf(std::streambuf &destination)
+        : destination_(destination)
+    {
+    }
+
+protected:
+    virtual int overflow(int c)
+    {
+        if (c == traits_type::eof())
+        {
+            return traits_type::not_eof(c);
+        }
+
+        if (destination_.sputc(static_cast<char>(c)) == traits_type::eof())
+        {
+            return traits_type::eof();
+        }
+
+        ++count_;
+
+        return c;
+    }
+
+    virtual std::streamsize xsputn(const char *s, std::streamsize n)
+    {
+        const auto written = destination_.sputn(s, n);
+        count_ += static_cast<std::uint64_t>(written);
+
+        return written;
+    }
+
+    virtual pos_type seekoff(off_type off, std::ios_base::seekdir way, std::ios_base::openmode)
+    {
+        if (off != 0 || way != std::ios_base::cur)
+        {
+            return pos_type(off_type(-1));
+        }
+
+        return pos_type(static_cast<off_type>(count_));
+    }
+
+    virtual int sync()
+    {
+        return destination_.pubsync();
+    }
+
+private:
+    std::streambuf &destination_;
+    std::uint64_t count_ = 0;
+};
+
+// Multiplies the 32x32 bit matrix mat over GF(2) with vec.
+std::uint32_t gf2_matrix_times(const std::array<std::uint32_t, 32> &mat, std::uint32_t vec)
+{
+    std::uint32_t sum = 0;
+
+    for (std::size_t n = 0; vec != 0; ++n, vec >>= 1)
+    {
+        if (vec & 1)
+        {
+            sum ^= mat[n];
+        }
+    }
+
+    return sum;
+}
+
+void gf2_matrix_square(std::array<std::uint32_t, 32> &square, const std::array<std::uint32_t, 32> &mat)
+{
+    for (std::size_t n = 0; n < 32; ++n)
+    {
+        square[n] = gf2_matrix_times(mat, mat[n]);
+    }
+}
+
+// Returns the CRC-32 of two consecutive blocks of data given the CRC-32 of each
+// block and the length of the second one, as crc32_combine in zlib which miniz
+// lacks. The first CRC is advanced over length zero bytes by repeatedly squaring
+// the operator that appends a single zero bit.
+std::uint32_t crc32_combine(std::uint32_t crc1, std::uint32_t crc2, std::uint64_t length2)
+{
+    if (length2 == 0)
+    {
+        return crc1;
+    }
+
+    std::array<std::uint32_t, 32> even; // operator for an even number of zero bits
+    std::array<std::uint32_t, 32> odd; // operator for an odd number of zero bits
+
+    odd[0] = 0xedb88320; // reversed CRC-32 polynomial
+    std::uint32_t row = 1;
+
+    for (std::size_t n = 1; n < 32; ++n)
+    {
+        odd[n] = row;
+        row <<= 1;
+    }
+
+    gf2_matrix_square(even, odd); // two zero bits
+    gf2_matrix_square(odd, even); // four zero bits
+
+    // the first squaring puts the operator for one zero byte in even
+    do
+    {
+        gf2_matrix_square(even, odd);
+
+        if (length2 & 1)
+        {
+            crc1 = gf2_matrix_times(even, crc1);
+        }
+
+        length2 >>= 1;
+
+        if (length2 == 0)
+        {
+            break;
+        }
+
+        gf2_matrix_square(odd, even);
+
+        if (length2 & 1)
+        {
+            crc1 = gf2_matrix_times(odd, crc1);
+        }
+
+        length2 >>= 1;
+    } while (length2 != 0);
+
+    return crc1 ^ crc2;
 }
 
 } // namespace
@@ -169,43 +467,49 @@ void write_header(const xlnt::detail::zheader &header, std::ostream &ostream, co
 namespace xlnt {
 namespace detail {
 
-static const std::size_t buffer_size = 512;
-
 class zip_streambuf_decompress : public std::streambuf
 {
-    std::istream &istream;
+    const izstream &archive;
+    std::uint64_t position;
 
     z_stream strm;
-    std::array<char, buffer_size> in;
-    std::array<char, buffer_size> out;
+    std::size_t buffer_size;
+    std::vector<char> in;
+    std::vector<char> out;
     zheader header;
-    std::size_t total_read;
-    std::size_t total_uncompressed;
+    std::uint64_t total_read;
+    std::uint64_t total_uncompressed;
     bool valid;
     bool compressed_data;
+    bool inflating;
+    bool finished;
 
     static const unsigned short DEFLATE = 8;
     static const unsigned short UNCOMPRESSED = 0;
 
 public:
-    zip_streambuf_decompress(std::istream &stream, zheader central_header)
-        : istream(stream), header(central_header), total_read(0), total_uncompressed(0), valid(true)
+    zip_streambuf_decompress(const izstream &source, const zheader &central_header, std::uint64_t data_position)
+        : archive(source),
+          position(data_position),
+          buffer_size(source.buffer_size_),
+          in(source.data_ != nullptr ? 0 : buffer_size, 0),
+          out(buffer_size, 0),
+          header(central_header),
+          total_read(0),
+          total_uncompressed(0),
+          valid(true),
+          inflating(false),
+          finished(false)
     {
-        in.fill(0);
-        out.fill(0);
-
         strm.zalloc = nullptr;
         strm.zfree = nullptr;
         strm.opaque = nullptr;
         strm.avail_in = 0;
         strm.next_in = nullptr;
 
-        setg(in.data(), in.data(), in.data());
+        setg(out.data() + 4, out.data() + 4, out.data() + 4);
         setp(nullptr, nullptr);
 
-        // skip the header
-        read_header(istream, false);
-
         if (header.compression_type == DEFLATE)
         {
             compressed_data = true;
@@ -233,8 +537,6 @@ public:
                 throw xlnt::exception("couldn't inflate ZIP, possibly corrupted");
             }
         }
-
-        header = central_header;
     }
 
     virtual ~zip_streambuf_decompress()
@@ -245,48 +547,56 @@ public:
         }
     }
 
-    int process()
+    std::size_t read_source(char *buffer, std::size_t count)
     {
-        if (!valid) return -1;
+        const auto read = archive.read_at(position, buffer, count);
+        position += read;
+        total_read += read;
+
+        return read;
+    }
+
+    // Decompresses up to count bytes into destination and returns the number of
+    // bytes written there, which is only 0 at the end of the file.
+    std::size_t process(char *destination, std::size_t count)
+    {
+        if (!valid || finished) return 0;
 
         if (compressed_data)
         {
-            strm.avail_out = buffer_size - 4;
-            strm.next_out = reinterpret_cast<Bytef *>(out.data() + 4);
+            inflating = true;
+            strm.avail_out = static_cast<unsigned int>(std::min(count, std::size_t(0x7fffffff)));
+            strm.next_out = reinterpret_cast<Bytef *>(destination);
 
             while (strm.avail_out != 0)
             {
                 if (strm.avail_in == 0)
                 {
-                    // buffer empty, read some more from file
-                    istream.read(in.data(),
-                        static_cast<std::streamsize>(std::min(buffer_size, header.compressed_size - total_read)));
-                    strm.avail_in = static_cast<unsigned int>(istream.gcount());
-                    total_read += strm.avail_in;
-                    strm.next_in = reinterpret_cast<Bytef *>(in.data());
+                    next_input(buffer_size);
                 }
 
                 const auto ret = inflate(&strm, Z_NO_FLUSH); // decompress
 
-                if (ret == Z_STREAM_ERROR || ret == Z_NEED_DICT || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR)
+                if (ret == Z_STREAM_ERROR || ret == Z_NEED_DICT || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR
+                    || (ret == Z_BUF_ERROR && strm.avail_in == 0))
                 {
                     throw xlnt::exception("couldn't inflate ZIP, possibly corrupted");
                 }
 
-                if (ret == Z_STREAM_END) break;
+                if (ret == Z_STREAM_END)
+                {
+                    finished = true;
+                    break;
+                }
             }
 
-            auto unzip_count = buffer_size - strm.avail_out - 4;
+            auto unzip_count = static_cast<std::size_t>(reinterpret_cast<char *>(strm.next_out) - destination);
             total_uncompressed += unzip_count;
-            return static_cast<int>(unzip_count);
+            return unzip_count;
         }
 
         // uncompressed, so just read
-        istream.read(out.data() + 4,
-            static_cast<std::streamsize>(std::min(buffer_size - 4, header.uncompressed_size - total_read)));
-        auto count = istream.gcount();
-        total_read += static_cast<std::size_t>(count);
-        return static_cast<int>(count);
+        return read_source(destination, static_cast<std::size_t>(std::min<std::uint64_t>(count, header.uncompressed_size - total_read)));
     }
 
     virtual int underflow()
@@ -297,197 +607,863 @@ public:
         if (put_back_count > 4) put_back_count = 4;
         std::memmove(
             out.data() + (4 - put_back_count), gptr() - put_back_count, static_cast<std::size_t>(put_back_count));
-        int num = process();
+        auto num = static_cast<std::ptrdiff_t>(process(out.data() + 4, buffer_size - 4));
         setg(out.data() + 4 - put_back_count, out.data() + 4, out.data() + 4 + num);
         if (num <= 0) return EOF;
         return traits_type::to_int_type(*gptr());
     }
 
-    virtual int overflow(int c = EOF);
-};
-
-int zip_streambuf_decompress::overflow(int)
-{
-    throw xlnt::exception("writing to read-only buffer");
-}
-
-class zip_streambuf_compress : public std::streambuf
-{
-    std::ostream &ostream; // owned when header==0 (when not part of zip file)
-
-    z_stream strm;
-    std::array<char, buffer_size> in;
-    std::array<char, buffer_size> out;
-
-    zheader *header;
-    std::uint32_t uncompressed_size;
-    std::uint32_t crc;
-
-    bool valid;
-
-public:
-    zip_streambuf_compress(zheader *central_header, std::ostream &stream)
-        : ostream(stream), header(central_header), valid(true)
+    // Points inflate at up to size more bytes of compressed data, which are read
+    // into in unless the archive is in memory and they can be used where they are.
+    void next_input(std::size_t size)
     {
-        strm.zalloc = nullptr;
-        strm.zfree = nullptr;
-        strm.opaque = nullptr;
-
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wold-style-cast"
-        int ret = deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
-#pragma clang diagnostic pop
+        size = static_cast<std::size_t>(std::min<std::uint64_t>(size, header.compressed_size - total_read));
 
-        if (ret != Z_OK)
+        if (archive.data_ != nullptr)
         {
-            std::cerr << "libz: failed to deflateInit" << std::endl;
-            valid = false;
-            return;
+            size = position < archive.data_size_
+                ? static_cast<std::size_t>(std::min<std::uint64_t>(size, archive.data_size_ - position))
+                : 0;
+            strm.next_in = const_cast<Bytef *>(archive.data_ + position);
+            position += size;
+            total_read += size;
         }
-
-        setg(nullptr, nullptr, nullptr);
-        setp(in.data(), in.data() + buffer_size - 4); // we want to be 4 aligned
-
-        // Write appropriate header
-        if (header)
+        else
         {
-            header->header_offset = static_cast<std::uint32_t>(stream.tellp());
-            write_header(*header, ostream, false);
+            in.resize(std::max(in.size(), size));
+            size = read_source(in.data(), size);
+            strm.next_in = reinterpret_cast<Bytef *>(in.data());
         }
 
-        uncompressed_size = crc = 0;
+        strm.avail_in = static_cast<unsigned int>(size);
     }
 
-    virtual ~zip_streambuf_compress()
+    // Inflates the whole file into destination with a single call, which lets
+    // inflate write straight into destination instead of through its window.
+    std::size_t inflate_all(char *destination, std::size_t count)
     {
-        if (valid)
+        inflating = true;
+        next_input(static_cast<std::size_t>(header.compressed_size));
+
+        strm.next_out = reinterpret_cast<Bytef *>(destination);
+        strm.avail_out = static_cast<unsigned int>(std::min(count, std::size_t(0x7fffffff)));
+
+        if (inflate(&strm, Z_FINISH) != Z_STREAM_END)
         {
-            process(true);
-            deflateEnd(&strm);
-            if (header)
-            {
-                auto final_position = ostream.tellp();
-                header->uncompressed_size = uncompressed_size;
-                header->crc = crc;
-                ostream.seekp(header->header_offset);
-                write_header(*header, ostream, false);
-                ostream.seekp(final_position);
-            }
-            else
-            {
-                write_int(ostream, crc);
-                write_int(ostream, uncompressed_size);
-            }
+            throw xlnt::exception("couldn't inflate ZIP, possibly corrupted");
         }
-        if (!header) delete &ostream;
+
+        finished = true;
+        const auto unzip_count = static_cast<std::size_t>(reinterpret_cast<char *>(strm.next_out) - destination);
+        total_uncompressed += unzip_count;
+
+        return unzip_count;
     }
 
-protected:
-    int process(bool flush)
+    // Large reads such as reading a whole part are inflated straight into the
+    // caller's buffer rather than through out.
+    virtual std::streamsize xsgetn(char *destination, std::streamsize count)
     {
-        if (!valid) return -1;
+        if (compressed_data && !inflating && count >= static_cast<std::streamsize>(header.uncompressed_size)
+            && count <= 0x7fffffff && header.compressed_size <= 0x7fffffff)
+        {
+            return static_cast<std::streamsize>(inflate_all(destination, static_cast<std::size_t>(count)));
+        }
 
-        strm.next_in = reinterpret_cast<Bytef *>(pbase());
-        strm.avail_in = static_cast<unsigned int>(pptr() - pbase());
+        auto copied = std::min(count, static_cast<std::streamsize>(egptr() - gptr()));
+        std::memcpy(destination, gptr(), static_cast<std::size_t>(copied));
+        gbump(static_cast<int>(copied));
 
-        while (strm.avail_in != 0 || flush)
+        if (copied == count)
         {
-            strm.avail_out = buffer_size;
-            strm.next_out = reinterpret_cast<Bytef *>(out.data());
+            return copied;
+        }
 
-            int ret = deflate(&strm, flush ? Z_FINISH : Z_NO_FLUSH);
+        while (copied < count)
+        {
+            const auto read = process(destination + copied, static_cast<std::size_t>(count - copied));
 
-            if (!(ret != Z_BUF_ERROR && ret != Z_STREAM_ERROR))
+            if (read == 0)
             {
-                valid = false;
-                std::cerr << "gzip: gzip error " << strm.msg << std::endl;
-                return -1;
+                break;
             }
 
-            auto generated_output = static_cast<int>(strm.next_out - reinterpret_cast<std::uint8_t *>(out.data()));
-            ostream.write(out.data(), generated_output);
-            if (header) header->compressed_size += static_cast<std::uint32_t>(generated_output);
-            if (ret == Z_STREAM_END) break;
+            copied += static_cast<std::streamsize>(read);
         }
 
-        // update counts, crc's and buffers
-        auto consumed_input = static_cast<std::uint32_t>(pptr() - pbase());
-        uncompressed_size += consumed_input;
-        crc = static_cast<std::uint32_t>(crc32(crc, reinterpret_cast<Bytef *>(in.data()), consumed_input));
-        setp(pbase(), pbase() + buffer_size - 4);
+        // nothing in out can be put back any more
+        setg(out.data() + 4, out.data() + 4, out.data() + 4);
 
-        return 1;
+        return copied;
     }
 
-    virtual int sync()
+    // The number of bytes left in the file, according to the header.
+    virtual std::streamsize showmanyc()
     {
-        if (pptr() && pptr() > pbase()) return process(false);
-        return 0;
-    }
+        const auto left = static_cast<std::streamsize>(header.uncompressed_size)
+            - static_cast<std::streamsize>(compressed_data ? total_uncompressed : total_read);
 
-    virtual int underflow()
-    {
-        throw xlnt::exception("Attempt to read write only ostream");
+        return left > 0 ? left : 0;
     }
 
     virtual int overflow(int c = EOF);
 };
 
-int zip_streambuf_compress::overflow(int c)
+int zip_streambuf_decompress::overflow(int)
 {
-    if (c != EOF)
-    {
-        *pptr() = static_cast<char>(c);
-        pbump(1);
-    }
-    if (process(false) == EOF) return EOF;
-    return c;
+    throw xlnt::exception("writing to read-only buffer");
 }
 
-ozstream::ozstream(std::ostream &stream)
-    : destination_stream_(stream)
+/// <summary>
+/// Inflates files of an izstream into memory on background threads, in order,
+/// before they're opened, holding at most a given number of bytes at once.
+/// </summary>
+class zip_prefetcher
 {
-    if (!destination_stream_)
+    enum class file_status
     {
-        throw xlnt::exception("bad zip stream");
-    }
-}
-
-ozstream::~ozstream()
-{
-    // Write all file headers
-    auto final_position = destination_stream_.tellp();
+        queued,
+        inflating,
+        inflated,
+        opened
+    };
 
-    for (const auto &header : file_headers_)
+    struct prefetched_file
     {
-        write_header(header, destination_stream_, true);
-    }
+        path name;
+        std::size_t size;
+        file_status status;
+        std::string bytes;
+        bool failed;
+    };
+
+    // shared with the streambufs returned by open, which give their bytes back to the
+    // budget when they're destroyed
+    struct shared_state
+    {
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::vector<prefetched_file> files;
+        std::unordered_map<std::string, std::size_t> index;
+        std::size_t next = 0;
+        std::size_t budget = 0;
+        std::size_t used = 0;
+        bool stopped = false;
+    };
+
+    class prefetched_streambuf : public std::streambuf
+    {
+    public:
+        prefetched_streambuf(std::shared_ptr<shared_state> state, std::string &&bytes, std::size_t reserved)
+            : state_(std::move(state)),
+              bytes_(std::move(bytes)),
+              reserved_(reserved)
+        {
+            setg(&bytes_[0], &bytes_[0], &bytes_[0] + bytes_.size());
+        }
 
-    auto central_end = destination_stream_.tellp();
+        virtual ~prefetched_streambuf()
+        {
+            {
+                std::lock_guard<std::mutex> lock(state_->mutex);
+                state_->used -= reserved_;
+            }
 
-    // Write end of central
+            state_->changed.notify_all();
+        }
+
+    private:
+        std::shared_ptr<shared_state> state_;
+        std::string bytes_;
+        std::size_t reserved_;
+    };
+
+public:
+    zip_prefetcher(const izstream &source, const std::vector<path> &files, std::size_t thread_count, std::size_t memory_budget)
+        : state_(std::make_shared<shared_state>())
+    {
+        state_->budget = memory_budget;
+
+        for (const auto &file : files)
+        {
+            auto key = izstream::normalize(file);
+            const auto entry = source.file_headers_.find(key);
+
+            if (entry == source.file_headers_.end() || state_->index.count(key) != 0)
+            {
+                continue;
+            }
+
+            state_->index[key] = state_->files.size();
+            state_->files.push_back({path(entry->second.header.filename),
+                static_cast<std::size_t>(entry->second.header.uncompressed_size), file_status::queued, std::string(), false});
+        }
+
+        thread_count = std::min(thread_count, state_->files.size());
+
+        for (std::size_t i = 0; i < thread_count; ++i)
+        {
+            threads_.emplace_back(&zip_prefetcher::inflate_files, state_, std::cref(source));
+        }
+    }
+
+    ~zip_prefetcher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            state_->stopped = true;
+        }
+
+        state_->changed.notify_all();
+
+        for (auto &thread : threads_)
+        {
+            thread.join();
+        }
+    }
+
+    /// <summary>
+    /// Returns the file with the given normalized name from memory, waiting for it if it's
+    /// being inflated, or nullptr if it should be read from the archive as usual.
+    /// </summary>
+    std::unique_ptr<std::streambuf> open(const std::string &key)
+    {
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        const auto match = state_->index.find(key);
+
+        if (match == state_->index.end())
+        {
+            return nullptr;
+        }
+
+        auto &file = state_->files[match->second];
+
+        if (file.status == file_status::queued)
+        {
+            // read by the caller instead, so the threads skip it, including one waiting for it to fit
+            file.status = file_status::opened;
+            state_->changed.notify_all();
+
+            return nullptr;
+        }
+
+        state_->changed.wait(lock, [&file]() { return file.status != file_status::inflating; });
+
+        if (file.status == file_status::opened)
+        {
+            return nullptr;
+        }
+
+        file.status = file_status::opened;
+
+        if (file.failed)
+        {
+            // reading it again as usual throws the same exception in the caller
+            state_->used -= file.size;
+            state_->changed.notify_all();
+
+            return nullptr;
+        }
+
+        return std::unique_ptr<std::streambuf>(new prefetched_streambuf(state_, std::move(file.bytes), file.size));
+    }
+
+private:
+    static void inflate_files(std::shared_ptr<shared_state> state, const izstream &source)
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+
+        while (true)
+        {
+            // files opened before a thread got to them and files which will never fit are skipped
+            while (state->next < state->files.size()
+                && (state->files[state->next].status != file_status::queued
+                       || state->files[state->next].size > state->budget))
+            {
+                ++state->next;
+            }
+
+            if (state->stopped || state->next == state->files.size())
+            {
+                return;
+            }
+
+            auto &file = state->files[state->next];
+
+            if (state->used + file.size > state->budget)
+            {
+                state->changed.wait(lock);
+                continue;
+            }
+
+            ++state->next;
+            state->used += file.size;
+            file.status = file_status::inflating;
+            lock.unlock();
+
+            std::string bytes;
+            auto failed = false;
+
+            try
+            {
+                bytes = source.read(file.name);
+            }
+            catch (...)
+            {
+                failed = true;
+            }
+
+            lock.lock();
+            file.bytes = std::move(bytes);
+            file.failed = failed;
+            file.status = file_status::inflated;
+            state->changed.notify_all();
+        }
+    }
+
+    std::shared_ptr<shared_state> state_;
+    std::vector<std::thread> threads_;
+};
+
+/// <summary>
+/// A streambuf returned by ozstream::open, which writes the end of its file to the
+/// archive when it's finished or, if it wasn't, when it's destroyed.
+/// </summary>
+class zip_streambuf_file : public std::streambuf
+{
+public:
+    /// <summary>
+    /// Writes the rest of the file and completes its local header, throwing if this fails.
+    /// Does nothing if it was called before, even if that call failed.
+    /// </summary>
+    virtual void finish() = 0;
+};
+
+class zip_streambuf_compress : public zip_streambuf_file
+{
+    std::ostream &ostream; // owned when header==0 (when not part of zip file)
+
+    z_stream strm;
+    std::size_t buffer_size;
+    std::vector<char> in;
+    std::vector<char> out;
+
+    zheader *header;
+    std::uint64_t uncompressed_size;
+    std::uint32_t crc;
+
+    bool valid;
+    bool stored; // written as is with the STORE method instead of deflated
+    bool zip64; // the local header is written with a ZIP64 extra field
+    bool finished = false;
+
+public:
+    zip_streambuf_compress(zheader *central_header, std::ostream &stream, int level, std::size_t buffer, bool force_zip64 = false)
+        : ostream(stream),
+          buffer_size(buffer),
+          in(buffer_size),
+          out(buffer_size),
+          header(central_header),
+          valid(true),
+          stored(central_header && central_header->compression_type == 0),
+          zip64(force_zip64)
+    {
+        strm.zalloc = nullptr;
+        strm.zfree = nullptr;
+        strm.opaque = nullptr;
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+        int ret = stored ? Z_OK : deflateInit2(&strm, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+#pragma clang diagnostic pop
+
+        if (ret != Z_OK)
+        {
+            std::cerr << "libz: failed to deflateInit" << std::endl;
+            valid = false;
+            return;
+        }
+
+        setg(nullptr, nullptr, nullptr);
+        setp(in.data(), in.data() + buffer_size - 4); // we want to be 4 aligned
+
+        // Write appropriate header
+        if (header)
+        {
+            start_local_header(*header, ostream, zip64);
+        }
+
+        uncompressed_size = crc = 0;
+    }
+
+    virtual ~zip_streambuf_compress()
+    {
+        try
+        {
+            finish();
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "gzip: gzip error " << e.what() << std::endl;
+        }
+
+        if (valid && !stored) deflateEnd(&strm);
+        if (!header) delete &ostream;
+    }
+
+    virtual void finish()
+    {
+        if (finished || !valid) return;
+        finished = true;
+
+        process(true);
+
+        if (header)
+        {
+            header->uncompressed_size = uncompressed_size;
+            header->crc = crc;
+            finish_local_header(*header, ostream, zip64);
+        }
+        else
+        {
+            write_int(ostream, crc);
+            write_int(ostream, static_cast<std::uint32_t>(uncompressed_size));
+        }
+    }
+
+protected:
+    int process(bool flush)
+    {
+        if (!valid) return -1;
+
+        if (stored)
+        {
+            ostream.write(pbase(), pptr() - pbase());
+            header->compressed_size += static_cast<std::uint64_t>(pptr() - pbase());
+            flush = false;
+        }
+
+        strm.next_in = reinterpret_cast<Bytef *>(pbase());
+        strm.avail_in = stored ? 0 : static_cast<unsigned int>(pptr() - pbase());
+
+        while (strm.avail_in != 0 || flush)
+        {
+            strm.avail_out = static_cast<unsigned int>(buffer_size);
+            strm.next_out = reinterpret_cast<Bytef *>(out.data());
+
+            int ret = deflate(&strm, flush ? Z_FINISH : Z_NO_FLUSH);
+
+            if (!(ret != Z_BUF_ERROR && ret != Z_STREAM_ERROR))
+            {
+                valid = false;
+                std::cerr << "gzip: gzip error " << strm.msg << std::endl;
+                return -1;
+            }
+
+            auto generated_output = static_cast<int>(strm.next_out - reinterpret_cast<std::uint8_t *>(out.data()));
+            ostream.write(out.data(), generated_output);
+            if (header) header->compressed_size += static_cast<std::uint64_t>(generated_output);
+            if (ret == Z_STREAM_END) break;
+        }
+
+        // update counts, crc's and buffers
+        auto consumed_input = static_cast<std::uint32_t>(pptr() - pbase());
+        uncompressed_size += consumed_input;
+        crc = update_crc32(crc, reinterpret_cast<const std::uint8_t *>(in.data()), consumed_input);
+        setp(pbase(), pbase() + buffer_size - 4);
+
+        return 1;
+    }
+
+    virtual int sync()
+    {
+        if (pptr() && pptr() > pbase()) return process(false);
+        return 0;
+    }
+
+    virtual int underflow()
+    {
+        throw xlnt::exception("Attempt to read write only ostream");
+    }
+
+    virtual int overflow(int c = EOF);
+};
+
+int zip_streambuf_compress::overflow(int c)
+{
+    if (c != EOF)
+    {
+        *pptr() = static_cast<char>(c);
+        pbump(1);
+    }
+    if (process(false) == EOF) return EOF;
+    return c;
+}
+
+/// <summary>
+/// Compresses a file like zip_streambuf_compress, but splits the data into blocks
+/// which are deflated on up to thread_count threads at once. Every block but the
+/// last ends with a sync flush, which ends the deflate data on a byte boundary
+/// without ending the stream, so the compressed blocks can be concatenated into
+/// one deflate stream. Blocks don't share a dictionary, which costs a little
+/// compression at the start of each block.
+/// </summary>
+class zip_streambuf_parallel_compress : public zip_streambuf_file
+{
+    struct compressed_block
+    {
+        std::vector<char> data;
+        std::uint32_t crc;
+        std::uint64_t uncompressed_size;
+    };
+
+    std::ostream &ostream;
+    zheader *header;
+    std::size_t thread_count;
+    std::size_t block_size;
+    int level;
+    bool zip64;
+
+    std::vector<char> in;
+    std::deque<std::future<compressed_block>> pending;
+    std::uint64_t uncompressed_size;
+    std::uint32_t crc;
+    bool finished = false;
+
+public:
+    zip_streambuf_parallel_compress(zheader *central_header, std::ostream &stream, int compression_level, std::size_t threads, std::size_t block, bool force_zip64)
+        : ostream(stream), header(central_header), thread_count(threads), block_size(block), level(compression_level), zip64(force_zip64), uncompressed_size(0), crc(0)
+    {
+        in.resize(block_size);
+        setg(nullptr, nullptr, nullptr);
+        setp(in.data(), in.data() + in.size());
+
+        start_local_header(*header, ostream, zip64);
+    }
+
+    virtual ~zip_streambuf_parallel_compress()
+    {
+        try
+        {
+            finish();
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "gzip: gzip error " << e.what() << std::endl;
+        }
+    }
+
+    // the blocks still being compressed, or all of them if there are fewer than
+    // thread_count, fail here if they fail at all
+    virtual void finish()
+    {
+        if (finished) return;
+        finished = true;
+
+        submit(true);
+
+        while (!pending.empty())
+        {
+            write_block();
+        }
+
+        header->uncompressed_size = uncompressed_size;
+        header->crc = crc;
+        finish_local_header(*header, ostream, zip64);
+    }
+
+protected:
+    static compressed_block deflate_block(std::vector<char> data, int level, bool last)
+    {
+        compressed_block block;
+        block.uncompressed_size = data.size();
+        block.crc = update_crc32(0, reinterpret_cast<const std::uint8_t *>(data.data()), data.size());
+
+        z_stream strm;
+        strm.zalloc = nullptr;
+        strm.zfree = nullptr;
+        strm.opaque = nullptr;
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+        if (deflateInit2(&strm, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            throw xlnt::exception("failed to deflateInit");
+        }
+#pragma clang diagnostic pop
+
+        // room for the sync flush marker on top of the bound for a finished stream
+        block.data.resize(deflateBound(&strm, static_cast<mz_ulong>(data.size())) + 16);
+        strm.next_in = reinterpret_cast<Bytef *>(data.data());
+        strm.avail_in = static_cast<unsigned int>(data.size());
+        strm.next_out = reinterpret_cast<Bytef *>(block.data.data());
+        strm.avail_out = static_cast<unsigned int>(block.data.size());
+
+        const auto ret = deflate(&strm, last ? Z_FINISH : Z_SYNC_FLUSH);
+        const auto compressed_size = strm.total_out;
+        deflateEnd(&strm);
+
+        if (ret != (last ? Z_STREAM_END : Z_OK) || strm.avail_in != 0 || strm.avail_out == 0)
+        {
+            throw xlnt::exception("failed to deflate block");
+        }
+
+        block.data.resize(static_cast<std::size_t>(compressed_size));
+
+        return block;
+    }
+
+    void write_block()
+    {
+        auto block = pending.front().get();
+        pending.pop_front();
+
+        ostream.write(block.data.data(), static_cast<std::streamsize>(block.data.size()));
+        header->compressed_size += static_cast<std::uint64_t>(block.data.size());
+        crc = crc32_combine(crc, block.crc, block.uncompressed_size);
+        uncompressed_size += block.uncompressed_size;
+    }
+
+    // Starts compressing the data in the put area. When last is true, this is done
+    // even if there is no data so that the stream is finished.
+    void submit(bool last)
+    {
+        // bounds the memory used to thread_count blocks being compressed and one being filled
+        while (pending.size() >= thread_count)
+        {
+            write_block();
+        }
+
+        in.resize(static_cast<std::size_t>(pptr() - pbase()));
+
+        if (last && pending.empty())
+        {
+            pending.push_back(std::async(std::launch::deferred, deflate_block, std::move(in), level, last));
+        }
+        else
+        {
+            pending.push_back(std::async(std::launch::async, deflate_block, std::move(in), level, last));
+        }
+
+        in = std::vector<char>(block_size);
+        setp(in.data(), in.data() + in.size());
+    }
+
+    virtual int sync()
+    {
+        return 0;
+    }
+
+    virtual int underflow()
+    {
+        throw xlnt::exception("Attempt to read write only ostream");
+    }
+
+    virtual int overflow(int c = EOF)
+    {
+        submit(false);
+
+        if (c != EOF)
+        {
+            *pptr() = static_cast<char>(c);
+            pbump(1);
+        }
+
+        return traits_type::not_eof(c);
+    }
+};
+
+ozstream::ozstream(std::ostream &stream)
+    : data_descriptors_(stream.tellp() == std::streampos(-1)),
+      counting_buffer_(data_descriptors_ ? new counting_streambuf(*stream.rdbuf()) : nullptr),
+      counting_stream_(data_descriptors_ ? new std::ostream(counting_buffer_.get()) : nullptr),
+      destination_stream_(data_descriptors_ ? *counting_stream_ : stream)
+{
+    if (!stream)
+    {
+        throw xlnt::exception("bad zip stream");
+    }
+}
+
+ozstream::ozstream(zentries &entries)
+    : entries_(&entries),
+      entries_buffer_(new vector_ostreambuf(entries.data)),
+      entries_stream_(new std::ostream(entries_buffer_.get())),
+      destination_stream_(*entries_stream_)
+{
+}
+
+ozstream::~ozstream()
+{
+    try
+    {
+        finish();
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "zip: zip error " << e.what() << std::endl;
+    }
+}
+
+void ozstream::finish()
+{
+    if (finished_)
+    {
+        return;
+    }
+
+    finished_ = true;
+
+    if (entries_ != nullptr)
+    {
+        entries_->headers = std::move(file_headers_);
+        return;
+    }
+
+    // Write all file headers
+    const auto final_position = static_cast<std::uint64_t>(destination_stream_.tellp());
+
+    for (const auto &header : file_headers_)
+    {
+        write_header(header, destination_stream_, true, zip64_);
+    }
+
+    const auto central_end = static_cast<std::uint64_t>(destination_stream_.tellp());
+    const auto central_size = central_end - final_position;
+    const auto file_count = static_cast<std::uint64_t>(file_headers_.size());
+    const auto zip64 = zip64_ || file_count >= 0xffff || central_size >= zip64_limit || final_position >= zip64_limit;
+
+    if (zip64)
+    {
+        // ZIP64 end of central directory record
+        write_int(destination_stream_, static_cast<std::uint32_t>(0x06064b50));
+        write_int(destination_stream_, static_cast<std::uint64_t>(44)); // size of the rest of the record
+        write_int(destination_stream_, zip64_version); // version made by
+        write_int(destination_stream_, zip64_version); // version needed
+        write_int(destination_stream_, static_cast<std::uint32_t>(0)); // this disk number
+        write_int(destination_stream_, static_cast<std::uint32_t>(0)); // disk with the central directory
+        write_int(destination_stream_, file_count); // entries on this disk
+        write_int(destination_stream_, file_count); // entries
+        write_int(destination_stream_, central_size); // size of central directory
+        write_int(destination_stream_, final_position); // offset to central directory
+
+        // ZIP64 end of central directory locator
+        write_int(destination_stream_, static_cast<std::uint32_t>(0x07064b50));
+        write_int(destination_stream_, static_cast<std::uint32_t>(0)); // disk with the ZIP64 record
+        write_int(destination_stream_, central_end); // offset to the ZIP64 record
+        write_int(destination_stream_, static_cast<std::uint32_t>(1)); // number of disks
+    }
+
+    // Write end of central, with the values in the ZIP64 record replaced by 0xffff(ffff) if they don't fit
+    const auto count_field = static_cast<std::uint16_t>(zip64 ? 0xffff : file_count);
     write_int(destination_stream_, static_cast<std::uint32_t>(0x06054b50)); // end of central
     write_int(destination_stream_, static_cast<std::uint16_t>(0)); // this disk number
     write_int(destination_stream_, static_cast<std::uint16_t>(0)); // this disk number
-    write_int(destination_stream_, static_cast<std::uint16_t>(file_headers_.size())); // one entry in center in this disk
-    write_int(destination_stream_, static_cast<std::uint16_t>(file_headers_.size())); // one entry in center
-    write_int(destination_stream_, static_cast<std::uint32_t>(central_end - final_position)); // size of header
-    write_int(destination_stream_, static_cast<std::uint32_t>(final_position)); // offset to header
+    write_int(destination_stream_, count_field); // one entry in center in this disk
+    write_int(destination_stream_, count_field); // one entry in center
+    write_int(destination_stream_, static_cast<std::uint32_t>(zip64 ? zip64_limit : central_size)); // size of header
+    write_int(destination_stream_, static_cast<std::uint32_t>(zip64 ? zip64_limit : final_position)); // offset to header
     write_int(destination_stream_, static_cast<std::uint16_t>(0)); // zip comment
+    destination_stream_.flush();
+}
+
+void ozstream::finish(std::unique_ptr<std::streambuf> &file)
+{
+    if (auto zip_file = dynamic_cast<zip_streambuf_file *>(file.get()))
+    {
+        zip_file->finish();
+    }
+
+    file.reset();
 }
 
 std::unique_ptr<std::streambuf> ozstream::open(const path &filename)
 {
+    return open(filename, compression_level_);
+}
+
+std::unique_ptr<std::streambuf> ozstream::open(const path &filename, int level)
+{
+    if (level < 0 || level > 9)
+    {
+        throw xlnt::invalid_parameter();
+    }
+
     zheader header;
     header.filename = filename.string();
+    header.compression_type = level == 0 ? 0 : 8;
+
+    if (data_descriptors_)
+    {
+        header.flags |= 0x08;
+    }
+
     file_headers_.push_back(header);
-    auto buffer = new zip_streambuf_compress(&file_headers_.back(), destination_stream_);
+
+    // stored files are only copied so there's nothing to gain from more threads
+    if (compression_threads_ > 1 && level != 0)
+    {
+        return std::unique_ptr<std::streambuf>(new zip_streambuf_parallel_compress(
+            &file_headers_.back(), destination_stream_, level, compression_threads_, compression_block_size_, zip64_));
+    }
+
+    auto buffer = new zip_streambuf_compress(&file_headers_.back(), destination_stream_, level, buffer_size_, zip64_);
 
     return std::unique_ptr<zip_streambuf_compress>(buffer);
 }
 
+void ozstream::append(const zentries &entries)
+{
+    const auto offset = static_cast<std::uint64_t>(destination_stream_.tellp());
+    destination_stream_.write(reinterpret_cast<const char *>(entries.data.data()),
+        static_cast<std::streamsize>(entries.data.size()));
+
+    for (auto header : entries.headers)
+    {
+        header.header_offset += offset;
+        file_headers_.push_back(header);
+    }
+}
+
+void ozstream::compression_level(int level)
+{
+    if (level < 0 || level > 9)
+    {
+        throw xlnt::invalid_parameter();
+    }
+
+    compression_level_ = level;
+}
+
+void ozstream::buffer_size(std::size_t size)
+{
+    if (size < 16)
+    {
+        throw xlnt::invalid_parameter();
+    }
+
+    buffer_size_ = size;
+}
+
+void ozstream::zip64(bool always)
+{
+    zip64_ = always;
+}
+
+void ozstream::compression_threads(std::size_t threads, std::size_t block_size)
+{
+    if (block_size == 0)
+    {
+        throw xlnt::invalid_parameter();
+    }
+
+    compression_threads_ = threads;
+    compression_block_size_ = block_size;
+}
+
 izstream::izstream(std::istream &stream)
-    : source_stream_(stream)
+    : source_stream_(stream),
+      source_position_(-1)
 {
     if (!stream)
     {
@@ -497,8 +1473,54 @@ izstream::izstream(std::istream &stream)
     read_central_header();
 }
 
+izstream::izstream(std::unique_ptr<std::istream> &&stream)
+    : owned_source_stream_(std::move(stream)),
+      source_stream_(*owned_source_stream_),
+      source_position_(-1)
+{
+    if (!source_stream_)
+    {
+        throw xlnt::exception("Invalid file handle");
+    }
+
+    read_central_header();
+}
+
+izstream::izstream(const std::uint8_t *data, std::size_t size)
+    : owned_source_stream_(new std::istream(nullptr)),
+      data_(data),
+      data_size_(size),
+      data_buffer_(new memory_istreambuf(reinterpret_cast<const char *>(data), size)),
+      source_stream_(*owned_source_stream_),
+      source_position_(-1)
+{
+    owned_source_stream_->rdbuf(data_buffer_.get());
+
+    if (data == nullptr || size == 0)
+    {
+        throw xlnt::exception("file is empty or malformed");
+    }
+
+    read_central_header();
+}
+
+izstream::izstream(std::unique_ptr<mapped_file> &&file)
+    : izstream(file->data(), file->size())
+{
+    mapped_file_ = std::move(file);
+}
+
+izstream::izstream(std::vector<std::uint8_t> &&data)
+    : izstream(data.data(), data.size())
+{
+    // moving the vector keeps its buffer where data_ points
+    owned_data_ = std::move(data);
+}
+
 izstream::~izstream()
 {
+    // the threads read from this archive
+    prefetcher_.reset();
 }
 
 bool izstream::read_central_header()
@@ -556,7 +1578,8 @@ bool izstream::read_central_header()
     }
 
     // seek to end of central header and read
-    source_stream_.seekg(end_position - (read_start - header_index));
+    const auto end_of_central_position = end_position - (read_start - header_index);
+    source_stream_.seekg(end_of_central_position);
 
     /*auto word = */ read_int<std::uint32_t>(source_stream_);
     auto disk_number1 = read_int<std::uint16_t>(source_stream_);
@@ -567,64 +1590,265 @@ bool izstream::read_central_header()
         throw xlnt::exception("multiple disk zip files are not supported");
     }
 
-    auto num_files = read_int<std::uint16_t>(source_stream_); // one entry in center in this disk
-    auto num_files_this_disk = read_int<std::uint16_t>(source_stream_); // one entry in center
+    std::uint64_t num_files = read_int<std::uint16_t>(source_stream_); // one entry in center in this disk
+    std::uint64_t num_files_this_disk = read_int<std::uint16_t>(source_stream_); // one entry in center
+
+    /*auto size_of_header = */ read_int<std::uint32_t>(source_stream_); // size of header
+    std::uint64_t header_offset = read_int<std::uint32_t>(source_stream_); // offset to header
+
+    // a ZIP64 end of central directory locator right before the end of central directory
+    // points to the ZIP64 record, which has the values that don't fit the fields above
+    const std::streamoff locator_size = 20;
+
+    if (end_of_central_position >= locator_size)
+    {
+        source_stream_.seekg(end_of_central_position - locator_size);
+
+        if (read_int<std::uint32_t>(source_stream_) == 0x07064b50)
+        {
+            /*auto zip64_disk = */ read_int<std::uint32_t>(source_stream_);
+            const auto zip64_record_offset = read_int<std::uint64_t>(source_stream_);
+            source_stream_.seekg(static_cast<std::streamoff>(zip64_record_offset));
+
+            if (read_int<std::uint32_t>(source_stream_) != 0x06064b50)
+            {
+                throw xlnt::exception("missing ZIP64 end of central directory signature");
+            }
+
+            /*auto record_size = */ read_int<std::uint64_t>(source_stream_);
+            /*auto version_made_by = */ read_int<std::uint16_t>(source_stream_);
+            /*auto version_needed = */ read_int<std::uint16_t>(source_stream_);
+            const auto zip64_disk_number1 = read_int<std::uint32_t>(source_stream_);
+            const auto zip64_disk_number2 = read_int<std::uint32_t>(source_stream_);
+
+            if (zip64_disk_number1 != zip64_disk_number2 || zip64_disk_number1 != 0)
+            {
+                throw xlnt::exception("multiple disk zip files are not supported");
+            }
+
+            num_files_this_disk = read_int<std::uint64_t>(source_stream_);
+            num_files = read_int<std::uint64_t>(source_stream_);
+            /*auto size_of_header = */ read_int<std::uint64_t>(source_stream_);
+            header_offset = read_int<std::uint64_t>(source_stream_);
+        }
+    }
 
     if (num_files != num_files_this_disk)
     {
         throw xlnt::exception("multi disk zip files are not supported");
     }
 
-    /*auto size_of_header = */ read_int<std::uint32_t>(source_stream_); // size of header
-    auto header_offset = read_int<std::uint32_t>(source_stream_); // offset to header
-
     // go to header and read all file headers
-    source_stream_.seekg(header_offset);
+    source_stream_.clear();
+    source_stream_.seekg(static_cast<std::streamoff>(header_offset));
 
-    for (std::uint16_t i = 0; i < num_files; ++i)
+    for (std::uint64_t i = 0; i < num_files; ++i)
     {
         auto header = read_header(source_stream_, true);
-        file_headers_[header.filename] = header;
+        auto key = normalize(path(header.filename));
+
+        // a later entry with the same name replaces an earlier one
+        file_headers_.erase(key);
+        file_headers_.emplace(std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+            std::forward_as_tuple(header));
     }
 
     return true;
 }
 
-std::unique_ptr<std::streambuf> izstream::open(const path &filename) const
+izstream::central_entry::central_entry(const zheader &central_header)
+    : header(central_header),
+      data_offset(0)
+{
+}
+
+std::string izstream::normalize(const path &filename)
 {
-    if (!has_file(filename))
+    auto key = filename.string();
+    std::replace(key.begin(), key.end(), '\\', '/');
+    const auto first = key.find_first_not_of('/');
+    key.erase(0, first == std::string::npos ? key.size() : first);
+    std::transform(key.begin(), key.end(), key.begin(),
+        [](char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; });
+
+    return key;
+}
+
+const izstream::central_entry &izstream::find(const path &filename) const
+{
+    const auto match = file_headers_.find(normalize(filename));
+
+    if (match == file_headers_.end())
     {
         throw xlnt::exception("file not found");
     }
 
-    auto header = file_headers_.at(filename.string());
-    source_stream_.seekg(header.header_offset);
-    auto buffer = new zip_streambuf_decompress(source_stream_, header);
+    return match->second;
+}
+
+std::unique_ptr<std::streambuf> izstream::open(const path &filename) const
+{
+    if (prefetcher_)
+    {
+        auto prefetched = prefetcher_->open(normalize(filename));
+
+        if (prefetched)
+        {
+            return prefetched;
+        }
+    }
+
+    const auto &entry = find(filename);
+    auto buffer = new zip_streambuf_decompress(*this, entry.header, data_offset(entry));
 
     return std::unique_ptr<zip_streambuf_decompress>(buffer);
 }
 
+std::size_t izstream::read_at(std::uint64_t offset, char *buffer, std::size_t count) const
+{
+    if (data_ != nullptr)
+    {
+        if (offset >= data_size_)
+        {
+            return 0;
+        }
+
+        const auto read = static_cast<std::size_t>(std::min<std::uint64_t>(count, data_size_ - offset));
+        std::memcpy(buffer, data_ + offset, read);
+
+        return read;
+    }
+
+    std::lock_guard<std::mutex> lock(source_mutex_);
+
+    if (source_position_ != static_cast<std::streamoff>(offset))
+    {
+        source_stream_.clear();
+        source_stream_.seekg(static_cast<std::streamoff>(offset));
+    }
+
+    source_stream_.read(buffer, static_cast<std::streamsize>(count));
+    const auto read = static_cast<std::size_t>(source_stream_.gcount());
+    source_position_ = source_stream_ ? static_cast<std::streamoff>(offset + read) : -1;
+
+    return read;
+}
+
 std::string izstream::read(const path &filename) const
 {
-    auto buffer = open(filename);
-    std::istream stream(buffer.get());
-    auto bytes = to_vector(stream);
+    const auto &entry = find(filename);
+    std::unique_ptr<std::streambuf> buffer(new zip_streambuf_decompress(*this, entry.header, data_offset(entry)));
+
+    // the whole file is inflated in one go when the size in the header is right
+    std::string bytes(static_cast<std::size_t>(entry.header.uncompressed_size), '\0');
+    bytes.resize(static_cast<std::size_t>(buffer->sgetn(&bytes[0], static_cast<std::streamsize>(bytes.size()))));
 
-    return std::string(bytes.begin(), bytes.end());
+    std::vector<char> rest(buffer_size_);
+    std::streamsize count = 0;
+
+    while ((count = buffer->sgetn(rest.data(), static_cast<std::streamsize>(rest.size()))) > 0)
+    {
+        bytes.append(rest.data(), static_cast<std::size_t>(count));
+    }
+
+    return bytes;
+}
+
+std::uint64_t izstream::data_offset(const central_entry &entry) const
+{
+    // no data starts at offset zero, so zero means the local header hasn't been read yet
+    const auto cached = entry.data_offset.load(std::memory_order_relaxed);
+
+    if (cached != 0)
+    {
+        return cached;
+    }
+
+    // skip the local header, its variable length fields may differ from the central header
+    const auto &header = entry.header;
+    std::array<std::uint8_t, 30> local_header;
+    if (read_at(header.header_offset, reinterpret_cast<char *>(local_header.data()), local_header.size()) != local_header.size()
+        || local_header[0] != 0x50 || local_header[1] != 0x4b || local_header[2] != 0x03 || local_header[3] != 0x04)
+    {
+        throw xlnt::exception("missing local header signature");
+    }
+
+    const auto filename_length = static_cast<std::uint64_t>(local_header[26] | (local_header[27] << 8));
+    const auto extra_length = static_cast<std::uint64_t>(local_header[28] | (local_header[29] << 8));
+
+    const auto offset = header.header_offset + local_header.size() + filename_length + extra_length;
+    entry.data_offset.store(offset, std::memory_order_relaxed);
+
+    return offset;
+}
+
+void izstream::copy(const path &filename, zentries &entries) const
+{
+    const auto &entry = find(filename);
+    auto header = entry.header;
+    auto position = data_offset(entry);
+
+    // the sizes and crc are written into the new local header so no data descriptor follows
+    header.flags &= static_cast<std::uint16_t>(~0x08);
+    header.extra.clear();
+    header.comment.clear();
+    header.header_offset = static_cast<std::uint64_t>(entries.data.size());
+
+    xlnt::detail::vector_ostreambuf entries_buffer(entries.data);
+    std::ostream entries_stream(&entries_buffer);
+    entries_stream.seekp(0, std::ios_base::end);
+    write_header(header, entries_stream, false);
+    entries_stream.flush();
+
+    auto remaining = static_cast<std::size_t>(header.compressed_size);
+    auto offset = entries.data.size();
+    entries.data.resize(offset + remaining);
+
+    if (read_at(position, reinterpret_cast<char *>(entries.data.data() + offset), remaining) != remaining)
+    {
+        throw xlnt::exception("unexpected end of archive");
+    }
+
+    entries.headers.push_back(header);
+}
+
+void izstream::buffer_size(std::size_t size)
+{
+    if (size < 16)
+    {
+        throw xlnt::invalid_parameter();
+    }
+
+    buffer_size_ = size;
+}
+
+void izstream::prefetch(const std::vector<path> &files, std::size_t threads, std::size_t memory_budget)
+{
+    prefetcher_.reset();
+
+    if (threads > 0 && !files.empty())
+    {
+        prefetcher_.reset(new zip_prefetcher(*this, files, threads, memory_budget));
+    }
+}
+
+void izstream::stop_prefetch()
+{
+    prefetcher_.reset();
 }
 
 std::vector<path> izstream::files() const
 {
     std::vector<path> filenames;
     std::transform(file_headers_.begin(), file_headers_.end(), std::back_inserter(filenames),
-        [](const std::pair<std::string, zheader> &h) { return path(h.first); });
+        [](const std::pair<const std::string, central_entry> &h) { return path(h.second.header.filename); });
 
     return filenames;
 }
 
 bool izstream::has_file(const path &filename) const
 {
-    return file_headers_.count(filename.string()) != 0;
+    return file_headers_.count(normalize(filename)) != 0;
 }
 
 } // namespace detail
@@ -35,8 +35,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 
 #pragma once
 
+#include <atomic>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -48,6 +50,10 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 namespace xlnt {
 namespace detail {
 
+class mapped_file;
+class zip_prefetcher;
+class zip_streambuf_decompress;
+
 /// <summary>
 /// A structure representing the header that occurs before each compressed file in a ZIP
 /// archive and again at the end of the file with more information.
@@ -60,12 +66,30 @@ struct XLNT_API zheader
     std::uint16_t stamp_date = 0;
     std::uint16_t stamp_time = 0;
     std::uint32_t crc = 0;
-    std::uint32_t compressed_size = 0;
-    std::uint32_t uncompressed_size = 0;
+    std::uint64_t compressed_size = 0;
+    std::uint64_t uncompressed_size = 0;
     std::string filename;
     std::string comment;
     std::vector<std::uint8_t> extra;
-    std::uint32_t header_offset = 0;
+    std::uint64_t header_offset = 0;
+};
+
+/// <summary>
+/// Compressed files which were written into memory by an ozstream and can be
+/// appended to another ozstream without being compressed again.
+/// </summary>
+struct XLNT_API zentries
+{
+    /// <summary>
+    /// The headers of the files in the order they were written. Header offsets
+    /// are relative to the start of data.
+    /// </summary>
+    std::vector<zheader> headers;
+
+    /// <summary>
+    /// The local headers and compressed data of the files.
+    /// </summary>
+    std::vector<std::uint8_t> data;
 };
 
 /// <summary>
@@ -80,6 +104,13 @@ public:
     /// </summary>
     ozstream(std::ostream &stream);
 
+    /// <summary>
+    /// Construct a new zip_file_writer which writes the compressed files into entries
+    /// instead of a complete archive. The central directory is left out and the
+    /// headers of the files are moved into entries when this object is destroyed.
+    /// </summary>
+    ozstream(zentries &entries);
+
     /// <summary>
     /// Destructor.
     /// </summary>
@@ -90,8 +121,114 @@ public:
     /// </summary>
     std::unique_ptr<std::streambuf> open(const path &file);
 
+    /// <summary>
+    /// Returns a pointer to a streambuf which compresses the data it receives with
+    /// the given deflate level from 1 to 9, or stores it uncompressed if level is 0.
+    /// </summary>
+    std::unique_ptr<std::streambuf> open(const path &file, int level);
+
+    /// <summary>
+    /// Finishes writing file, a streambuf returned by open(), and destroys it. Unlike
+    /// just destroying it, which only reports errors to std::cerr, this throws if the
+    /// file couldn't be compressed or written.
+    /// </summary>
+    void finish(std::unique_ptr<std::streambuf> &file);
+
+    /// <summary>
+    /// Writes the central directory, which ends the archive, or moves the headers into
+    /// the entries this object was constructed with, throwing if this fails. This is
+    /// otherwise done by the destructor, which only reports errors to std::cerr. Files
+    /// can't be added to the archive afterwards.
+    /// </summary>
+    void finish();
+
+    /// <summary>
+    /// Copies the files in entries to the end of the archive, keeping their order.
+    /// </summary>
+    void append(const zentries &entries);
+
+    /// <summary>
+    /// Sets the size of the buffers used to compress and write each file opened
+    /// after this call. The default is 64 KiB.
+    /// </summary>
+    void buffer_size(std::size_t size);
+
+    /// <summary>
+    /// Sets the level used by open(file) from 0, which stores files uncompressed,
+    /// to 9. The default is 6.
+    /// </summary>
+    void compression_level(int level);
+
+    /// <summary>
+    /// Sets the number of threads used to compress each file opened after this call.
+    /// With more than one thread, the data of a file is split into blocks of
+    /// block_size bytes which are compressed concurrently.
+    /// </summary>
+    void compression_threads(std::size_t threads, std::size_t block_size = 1024 * 1024);
+
+    /// <summary>
+    /// If true, every file opened after this call is written with ZIP64 sizes and
+    /// offsets and the archive ends with the ZIP64 end of central directory records,
+    /// whatever its size. Otherwise, which is the default, these are only written
+    /// for files and archives which don't fit the 32-bit fields.
+    /// </summary>
+    void zip64(bool always);
+
 private:
     std::vector<zheader> file_headers_;
+
+    /// <summary>
+    /// True if every file and the end of the archive are written in the ZIP64 format.
+    /// </summary>
+    bool zip64_ = false;
+
+    /// <summary>
+    /// True once finish() has been called.
+    /// </summary>
+    bool finished_ = false;
+
+    /// <summary>
+    /// True if destination_stream_ can't seek. The local header of each file is then
+    /// written before its size is known, so the sizes and crc follow its data in a
+    /// data descriptor instead.
+    /// </summary>
+    bool data_descriptors_ = false;
+
+    /// <summary>
+    /// The level used by open(file).
+    /// </summary>
+    int compression_level_ = 6;
+
+    /// <summary>
+    /// The size of the input and output buffers of each open file.
+    /// </summary>
+    std::size_t buffer_size_ = 65536;
+
+    /// <summary>
+    /// The number of threads used to compress a file and the size of the blocks
+    /// the file is split into when this is more than one.
+    /// </summary>
+    std::size_t compression_threads_ = 1;
+    std::size_t compression_block_size_ = 1024 * 1024;
+
+    /// <summary>
+    /// The entries written to by this object, if it was constructed with them.
+    /// </summary>
+    zentries *entries_ = nullptr;
+
+    /// <summary>
+    /// The buffer and stream writing into entries_->data.
+    /// </summary>
+    std::unique_ptr<std::streambuf> entries_buffer_;
+    std::unique_ptr<std::ostream> entries_stream_;
+
+    /// <summary>
+    /// The buffer and stream counting the bytes written to a stream which can't seek,
+    /// used in its place so the offsets of files are known.
+    /// </summary>
+    std::unique_ptr<std::streambuf> counting_buffer_;
+    std::unique_ptr<std::ostream> counting_stream_;
+
     std::ostream &destination_stream_;
 };
 
@@ -107,6 +244,31 @@ public:
     /// </summary>
     izstream(std::istream &stream);
 
+    /// <summary>
+    /// Construct a new zip_file_reader which takes ownership of the given stream
+    /// and reads a ZIP archive from it for as long as this object exists.
+    /// </summary>
+    izstream(std::unique_ptr<std::istream> &&stream);
+
+    /// <summary>
+    /// Construct a new zip_file_reader which reads a ZIP archive of size bytes at data,
+    /// which must stay valid for as long as this object exists. Compressed files are
+    /// inflated straight out of this memory.
+    /// </summary>
+    izstream(const std::uint8_t *data, std::size_t size);
+
+    /// <summary>
+    /// Construct a new zip_file_reader which takes ownership of the given mapped file
+    /// and reads a ZIP archive from its memory as izstream(data, size) does.
+    /// </summary>
+    izstream(std::unique_ptr<mapped_file> &&file);
+
+    /// <summary>
+    /// Construct a new zip_file_reader which takes ownership of data and reads
+    /// a ZIP archive from it as izstream(data, size) does.
+    /// </summary>
+    izstream(std::vector<std::uint8_t> &&data);
+
     /// <summary>
     /// Destructor.
     /// </summary>
@@ -132,21 +294,137 @@ public:
     /// </summary>
     bool has_file(const path &filename) const;
 
+    /// <summary>
+    /// Appends the compressed data of file to entries without decompressing it,
+    /// so it can be written to an ozstream as it is.
+    /// </summary>
+    void copy(const path &file, zentries &entries) const;
+
+    /// <summary>
+    /// Sets the size of the buffers used to read and decompress each file opened
+    /// after this call. The default is 64 KiB.
+    /// </summary>
+    void buffer_size(std::size_t size);
+
+    /// <summary>
+    /// Starts inflating files, in the given order, into memory on up to threads
+    /// background threads, so that open() can return them from memory. At most
+    /// memory_budget bytes of inflated files are held at once, including files
+    /// returned by open() whose streambufs still exist. Files larger than the budget,
+    /// and files opened before a thread gets to them, are read as usual when opened.
+    /// Replaces files given to an earlier call.
+    /// </summary>
+    void prefetch(const std::vector<path> &files, std::size_t threads, std::size_t memory_budget);
+
+    /// <summary>
+    /// Stops inflating files ahead of time and releases those which weren't opened.
+    /// </summary>
+    void stop_prefetch();
+
 private:
+    friend class zip_prefetcher;
+    friend class zip_streambuf_decompress;
+
+    /// <summary>
+    /// A file's central header and the offset of its data, which is found from
+    /// its local header the first time the file is opened and kept for later opens.
+    /// </summary>
+    struct central_entry
+    {
+        central_entry(const zheader &central_header);
+
+        zheader header;
+        mutable std::atomic<std::uint64_t> data_offset;
+    };
+
+    /// <summary>
+    /// Returns the key of filename in file_headers_. Part names are compared the way
+    /// OPC compares them: without a leading slash, with forward slashes and ignoring
+    /// ASCII case.
+    /// </summary>
+    static std::string normalize(const path &filename);
+
+    /// <summary>
+    /// Returns the entry of filename or throws xlnt::exception if there isn't one.
+    /// </summary>
+    const central_entry &find(const path &filename) const;
+
+    /// <summary>
+    /// Returns the offset in the source stream of the data of the file with the
+    /// given entry, following its local header.
+    /// </summary>
+    std::uint64_t data_offset(const central_entry &entry) const;
+
     /// <summary>
     ///
     /// </summary>
     bool read_central_header();
 
     /// <summary>
-    ///
+    /// Reads up to count bytes starting at the absolute offset in the source stream
+    /// into buffer and returns the number of bytes read. Each streambuf returned by
+    /// open() reads through this method so any number of them may be used at the
+    /// same time, including from different threads.
+    /// </summary>
+    std::size_t read_at(std::uint64_t offset, char *buffer, std::size_t count) const;
+
+    /// <summary>
+    /// The files in the central directory keyed by their normalized names.
+    /// </summary>
+    std::unordered_map<std::string, central_entry> file_headers_;
+
+    /// <summary>
+    /// The stream owned by this archive, if it was constructed with one.
     /// </summary>
-    std::unordered_map<std::string, zheader> file_headers_;
+    std::unique_ptr<std::istream> owned_source_stream_;
+
+    /// <summary>
+    /// The mapped file owned by this archive, if it was constructed with one.
+    /// </summary>
+    std::unique_ptr<mapped_file> mapped_file_;
+
+    /// <summary>
+    /// The bytes owned by this archive, if it was constructed with a vector.
+    /// </summary>
+    std::vector<std::uint8_t> owned_data_;
+
+    /// <summary>
+    /// The archive in memory, or nullptr if it's read from a stream, and its size.
+    /// </summary>
+    const std::uint8_t *data_ = nullptr;
+    std::size_t data_size_ = 0;
+
+    /// <summary>
+    /// The buffer and stream the central directory is read through when the archive
+    /// is in memory.
+    /// </summary>
+    std::unique_ptr<std::streambuf> data_buffer_;
 
     /// <summary>
     ///
     /// </summary>
     std::istream &source_stream_;
+
+    /// <summary>
+    /// Serializes access to source_stream_.
+    /// </summary>
+    mutable std::mutex source_mutex_;
+
+    /// <summary>
+    /// The position of source_stream_ after the last read_at, or -1 if unknown.
+    /// Used to skip the seek when reads are sequential.
+    /// </summary>
+    mutable std::streamoff source_position_;
+
+    /// <summary>
+    /// The size of the input and output buffers of each open file.
+    /// </summary>
+    std::size_t buffer_size_ = 65536;
+
+    /// <summary>
+    /// The threads inflating files ahead of time, if prefetch() was called.
+    /// </summary>
+    std::unique_ptr<zip_prefetcher> prefetcher_;
 };
 
 } // namespace detail
@@ -0,0 +1,55 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+// Copyright (c) 2010-2015 openpyxl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <xlnt/utils/exceptions.hpp>
+#include <xlnt/workbook/load_options.hpp>
+
+namespace xlnt {
+
+void load_options::keep_columns(const std::string &title, column_t first, column_t last)
+{
+    if (first.index == 0 || last < first)
+    {
+        throw invalid_parameter();
+    }
+
+    auto &columns = worksheet_columns[title];
+
+    for (auto column = first; column <= last; ++column)
+    {
+        columns.push_back(column);
+    }
+}
+
+void load_options::keep_rows(const std::string &title, row_t first, row_t last)
+{
+    if (first == 0 || last < first)
+    {
+        throw invalid_parameter();
+    }
+
+    worksheet_rows[title] = std::make_pair(first, last);
+}
+
+} // namespace xlnt
@@ -0,0 +1,50 @@
+// Copyright (c) 2014-2020 Thomas Fussell
+// Copyright (c) 2010-2015 openpyxl
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <xlnt/workbook/row_batch.hpp>
+
+namespace xlnt {
+
+std::size_t row_batch::size() const
+{
+    return types.size();
+}
+
+std::string row_batch::string(std::size_t index) const
+{
+    return string_data.substr(string_offsets.at(index), string_offsets.at(index + 1) - string_offsets.at(index));
+}
+
+void row_batch::clear()
+{
+    row_count = 0;
+    rows.clear();
+    columns.clear();
+    types.clear();
+    numbers.clear();
+    string_offsets.assign(1, 0);
+    string_data.clear();
+}
+
+} // namespace xlnt
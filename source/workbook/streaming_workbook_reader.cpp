@@ -25,9 +25,11 @@
 
 #include <xlnt/cell/cell.hpp>
 #include <xlnt/packaging/manifest.hpp>
+#include <xlnt/utils/exceptions.hpp>
 #include <xlnt/utils/optional.hpp>
 #include <xlnt/workbook/streaming_workbook_reader.hpp>
 #include <xlnt/workbook/workbook.hpp>
+#include <xlnt/worksheet/row_properties.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/serialization/open_stream.hpp>
@@ -64,6 +66,17 @@ cell streaming_workbook_reader::read_cell()
     return consumer_->read_cell();
 }
 
+const row_batch &streaming_workbook_reader::read_rows(std::size_t count)
+{
+    consumer_->read_rows(count, batch_);
+    return batch_;
+}
+
+const row_properties &streaming_workbook_reader::current_row_properties() const
+{
+    return consumer_->streaming_row_properties_;
+}
+
 bool streaming_workbook_reader::has_worksheet(const std::string &name)
 {
     auto titles = sheet_titles();
@@ -77,6 +90,7 @@ void streaming_workbook_reader::begin_worksheet(const std::string &title)
         throw xlnt::exception("sheet not found");
     }
 
+    consumer_->options_.worksheet_rows.erase(title);
     worksheet_rel_id_ = workbook_->impl().sheet_title_rel_id_map_.at(title);
     const auto workbook_rel = workbook_->manifest()
                                   .relationship(path("/"), relationship_type::office_document);
@@ -111,6 +125,17 @@ void streaming_workbook_reader::begin_worksheet(const std::string &title)
     consumer_->read_worksheet_begin(worksheet_rel_id_);
 }
 
+void streaming_workbook_reader::begin_worksheet(const std::string &title, row_t first_row, row_t last_row)
+{
+    if (first_row == 0 || last_row < first_row)
+    {
+        throw xlnt::invalid_parameter();
+    }
+
+    begin_worksheet(title);
+    consumer_->options_.keep_rows(title, first_row, last_row);
+}
+
 worksheet streaming_workbook_reader::end_worksheet()
 {
     return consumer_->read_worksheet_end(worksheet_rel_id_);
@@ -24,6 +24,7 @@
 
 #include <algorithm>
 #include <array>
+#include <cstdio>
 #include <fstream>
 #include <functional>
 #include <set>
@@ -42,8 +43,10 @@
 #include <xlnt/utils/exceptions.hpp>
 #include <xlnt/utils/path.hpp>
 #include <xlnt/utils/variant.hpp>
+#include <xlnt/workbook/load_options.hpp>
 #include <xlnt/workbook/metadata_property.hpp>
 #include <xlnt/workbook/named_range.hpp>
+#include <xlnt/workbook/save_options.hpp>
 #include <xlnt/workbook/theme.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/workbook/workbook_view.hpp>
@@ -57,6 +60,7 @@
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/implementations/worksheet_impl.hpp>
 #include <detail/serialization/excel_thumbnail.hpp>
+#include <detail/serialization/mapped_file.hpp>
 #include <detail/serialization/open_stream.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_consumer.hpp>
@@ -66,6 +70,38 @@ namespace {
 
 using xlnt::detail::open_stream;
 
+// Reads a worksheet that was skipped by a load with load_options::lazy_worksheets
+// before it is handed out.
+xlnt::detail::worksheet_impl *read_if_unread(xlnt::detail::worksheet_impl &impl)
+{
+    if (impl.unread_)
+    {
+        xlnt::detail::xlsx_consumer consumer(*impl.parent_);
+        consumer.read_unread_worksheet(impl);
+    }
+
+    return &impl;
+}
+
+void read_unread_worksheets(xlnt::detail::workbook_impl &impl)
+{
+    for (auto &worksheet : impl.worksheets_)
+    {
+        read_if_unread(worksheet);
+    }
+}
+
+// Brings a loaded workbook into a state that can be written by xlsx_producer.
+void prepare_for_save(xlnt::detail::workbook_impl &impl)
+{
+    if (impl.load_options_.values_only)
+    {
+        throw xlnt::exception("workbook loaded with load_options::values_only can't be saved");
+    }
+
+    read_unread_worksheets(impl);
+}
+
 template <typename T>
 std::vector<T> keys(const std::vector<std::pair<T, xlnt::variant>> &container)
 {
@@ -642,7 +678,7 @@ const worksheet workbook::sheet_by_title(const std::string &title) const
     {
         if (impl.title_ == title)
         {
-            return worksheet(&impl);
+            return worksheet(read_if_unread(impl));
         }
     }
 
@@ -655,7 +691,7 @@ worksheet workbook::sheet_by_title(const std::string &title)
     {
         if (impl.title_ == title)
         {
-            return worksheet(&impl);
+            return worksheet(read_if_unread(impl));
         }
     }
 
@@ -676,7 +712,7 @@ worksheet workbook::sheet_by_index(std::size_t index)
         ++iter;
     }
 
-    return worksheet(&*iter);
+    return worksheet(read_if_unread(*iter));
 }
 
 const worksheet workbook::sheet_by_index(std::size_t index) const
@@ -687,7 +723,7 @@ const worksheet workbook::sheet_by_index(std::size_t index) const
     {
     }
 
-    return worksheet(&*iter);
+    return worksheet(read_if_unread(*iter));
 }
 
 worksheet workbook::sheet_by_id(std::size_t id)
@@ -696,7 +732,7 @@ worksheet workbook::sheet_by_id(std::size_t id)
     {
         if (impl.id_ == id)
         {
-            return worksheet(&impl);
+            return worksheet(read_if_unread(impl));
         }
     }
 
@@ -709,7 +745,7 @@ const worksheet workbook::sheet_by_id(std::size_t id) const
     {
         if (impl.id_ == id)
         {
-            return worksheet(&impl);
+            return worksheet(read_if_unread(impl));
         }
     }
 
@@ -862,13 +898,18 @@ range workbook::named_range(const std::string &name)
 }
 
 void workbook::load(std::istream &stream)
+{
+    load(stream, load_options());
+}
+
+void workbook::load(std::istream &stream, const load_options &options)
 {
     clear();
     detail::xlsx_consumer consumer(*this);
 
     try
     {
-        consumer.read(stream);
+        consumer.read(stream, options);
     }
     catch (xlnt::exception &e)
     {
@@ -886,14 +927,49 @@ void workbook::load(std::istream &stream)
 
 void workbook::load(const std::vector<std::uint8_t> &data)
 {
-    if (data.size() < 22) // the shortest ZIP file is 22 bytes
+    load(data, load_options());
+}
+
+void workbook::load(const std::vector<std::uint8_t> &data, const load_options &options)
+{
+    load(data.data(), data.size(), options);
+}
+
+void workbook::load(const std::uint8_t *data, std::size_t size)
+{
+    load(data, size, load_options());
+}
+
+void workbook::load(const std::uint8_t *data, std::size_t size, const load_options &options)
+{
+    if (data == nullptr || size < 22) // the shortest ZIP file is 22 bytes
     {
         throw xlnt::exception("file is empty or malformed");
     }
 
-    xlnt::detail::vector_istreambuf data_buffer(data);
+    clear();
+    detail::xlsx_consumer consumer(*this);
+
+    try
+    {
+        // worksheets read lazily are read after this returns so the archive needs its own copy
+        consumer.read(options.lazy_worksheets
+                ? std::make_shared<detail::izstream>(std::vector<std::uint8_t>(data, data + size))
+                : std::make_shared<detail::izstream>(data, size),
+            options);
+        return;
+    }
+    catch (xlnt::exception &e)
+    {
+        if (e.what() != std::string("xlnt::exception : encrypted xlsx, password required"))
+        {
+            throw;
+        }
+    }
+
+    xlnt::detail::memory_istreambuf data_buffer(reinterpret_cast<const char *>(data), size);
     std::istream data_stream(&data_buffer);
-    load(data_stream);
+    consumer.read(data_stream, "VelvetSweatshop");
 }
 
 void workbook::load(const std::string &filename)
@@ -903,6 +979,78 @@ void workbook::load(const std::string &filename)
 
 void workbook::load(const path &filename)
 {
+    load(filename, load_options());
+}
+
+void workbook::load(const path &filename, const load_options &options)
+{
+    std::unique_ptr<detail::mapped_file> mapping;
+
+    try
+    {
+        mapping.reset(new detail::mapped_file(filename.string()));
+    }
+    catch (xlnt::exception &)
+    {
+        // files that can't be mapped, such as empty files and pipes, are read as streams below
+    }
+
+    if (mapping)
+    {
+        clear();
+        detail::xlsx_consumer consumer(*this);
+
+        try
+        {
+            // parts are inflated straight out of the mapping, which the archive keeps
+            // for as long as lazily loaded worksheets need it
+            consumer.read(std::make_shared<detail::izstream>(std::move(mapping)), options);
+            return;
+        }
+        catch (xlnt::exception &e)
+        {
+            if (e.what() != std::string("xlnt::exception : encrypted xlsx, password required"))
+            {
+                throw;
+            }
+        }
+    }
+
+    if (options.lazy_worksheets)
+    {
+        // worksheets are read from the file after this returns so the archive owns the stream
+        std::unique_ptr<std::ifstream> lazy_file_stream(new std::ifstream());
+        open_stream(*lazy_file_stream, filename.string());
+
+        if (!lazy_file_stream->good())
+        {
+            throw xlnt::exception("file not found " + filename.string());
+        }
+
+        clear();
+        detail::xlsx_consumer consumer(*this);
+
+        try
+        {
+            consumer.read(std::move(lazy_file_stream), options);
+            return;
+        }
+        catch (xlnt::exception &e)
+        {
+            if (e.what() != std::string("xlnt::exception : encrypted xlsx, password required"))
+            {
+                throw;
+            }
+        }
+
+        // encrypted packages are decrypted into memory which is then kept by the archive
+        std::ifstream file_stream;
+        open_stream(file_stream, filename.string());
+        consumer.read(file_stream, "VelvetSweatshop");
+
+        return;
+    }
+
     std::ifstream file_stream;
     open_stream(file_stream, filename.string());
 
@@ -911,7 +1059,7 @@ void workbook::load(const path &filename)
         throw xlnt::exception("file not found " + filename.string());
     }
 
-    load(file_stream);
+    load(file_stream, options);
 }
 
 void workbook::load(const std::string &filename, const std::string &password)
@@ -977,6 +1125,9 @@ void workbook::save(const std::string &filename, const std::string &password) co
 
 void workbook::save(const path &filename) const
 {
+    // before the file is truncated
+    prepare_for_save(*d_);
+
     std::ofstream file_stream;
     open_stream(file_stream, filename.string());
     save(file_stream);
@@ -984,6 +1135,9 @@ void workbook::save(const path &filename) const
 
 void workbook::save(const path &filename, const std::string &password) const
 {
+    // before the file is truncated
+    prepare_for_save(*d_);
+
     std::ofstream file_stream;
     open_stream(file_stream, filename.string());
     save(file_stream, password);
@@ -991,19 +1145,89 @@ void workbook::save(const path &filename, const std::string &password) const
 
 void workbook::save(std::ostream &stream) const
 {
+    prepare_for_save(*d_);
     detail::xlsx_producer producer(*this);
     producer.write(stream);
 }
 
 void workbook::save(std::ostream &stream, const std::string &password) const
 {
+    prepare_for_save(*d_);
     detail::xlsx_producer producer(*this);
     producer.write(stream, password);
 }
 
+void workbook::save(std::vector<std::uint8_t> &data, const save_options &options) const
+{
+    xlnt::detail::vector_ostreambuf data_buffer(data);
+    std::ostream data_stream(&data_buffer);
+    save(data_stream, options);
+}
+
+void workbook::save(const path &filename, const save_options &options) const
+{
+    // before the file is truncated
+    prepare_for_save(*d_);
+
+    std::ofstream file_stream;
+    open_stream(file_stream, filename.string());
+    save(file_stream, options);
+}
+
+void workbook::save(std::ostream &stream, const save_options &options) const
+{
+    prepare_for_save(*d_);
+    detail::xlsx_producer producer(*this);
+    producer.write(stream, options);
+}
+
+void workbook::save_incremental(const path &filename) const
+{
+    save_incremental(filename, save_options());
+}
+
+void workbook::save_incremental(const path &filename, const save_options &options) const
+{
+    const auto temporary_filename = filename.string() + ".xlnt-tmp";
+
+    try
+    {
+        std::ofstream file_stream;
+        open_stream(file_stream, temporary_filename);
+
+        if (!file_stream.good())
+        {
+            throw xlnt::exception("couldn't create " + temporary_filename);
+        }
+
+        save(file_stream, options);
+        file_stream.close();
+
+        if (!file_stream.good())
+        {
+            throw xlnt::exception("couldn't write " + temporary_filename);
+        }
+    }
+    catch (...)
+    {
+        std::remove(temporary_filename.c_str());
+        throw;
+    }
+
+    // the existing package is only ever replaced in one step, so it's still there if this fails
+    if (!detail::replace_file(temporary_filename, filename.string()))
+    {
+        std::remove(temporary_filename.c_str());
+        throw xlnt::exception("couldn't replace " + filename.string());
+    }
+}
+
 #ifdef _MSC_VER
 void workbook::save(const std::wstring &filename) const
 {
+    // before the file is truncated
+    prepare_for_save(*d_);
+
     std::ofstream file_stream;
     open_stream(file_stream, filename);
     save(file_stream);
@@ -1011,6 +1235,9 @@ void workbook::save(const std::wstring &filename) const
 
 void workbook::save(const std::wstring &filename, const std::string &password) const
 {
+    // before the file is truncated
+    prepare_for_save(*d_);
+
     std::ofstream file_stream;
     open_stream(file_stream, filename);
     save(file_stream, password);
@@ -1132,9 +1359,10 @@ std::vector<std::string> workbook::sheet_titles() const
 {
     std::vector<std::string> names;
 
-    for (auto ws : *this)
+    // read from the impls as a worksheet handle would stop the worksheet from being copied on save
+    for (const auto &ws : d_->worksheets_)
     {
-        names.push_back(ws.title());
+        names.push_back(ws.title_);
     }
 
     return names;
@@ -1163,6 +1391,9 @@ void workbook::clear()
 
 bool workbook::operator==(const workbook &rhs) const
 {
+    read_unread_worksheets(*d_);
+    read_unread_worksheets(*rhs.d_);
+
     return *d_ == *rhs.d_;
 }
 
@@ -1180,9 +1411,10 @@ void workbook::swap(workbook &right)
 
     if (left.d_ != nullptr)
     {
-        for (auto ws : left)
+        // impls are updated directly so that worksheets which haven't been read yet stay unread
+        for (auto &impl : left.d_->worksheets_)
         {
-            ws.parent(left);
+            impl.parent_ = &left;
         }
 
         if (left.d_->stylesheet_.is_set())
@@ -1193,9 +1425,10 @@ void workbook::swap(workbook &right)
 
     if (right.d_ != nullptr)
     {
-        for (auto ws : right)
+        // impls are updated directly so that worksheets which haven't been read yet stay unread
+        for (auto &impl : right.d_->worksheets_)
         {
-            ws.parent(right);
+            impl.parent_ = &right;
         }
 
         if (right.d_->stylesheet_.is_set())
@@ -1224,9 +1457,9 @@ workbook::workbook(const workbook &other)
 {
     *d_.get() = *other.d_.get();
 
-    for (auto ws : *this)
+    for (auto &impl : d_->worksheets_)
     {
-        ws.parent(*this);
+        impl.parent_ = this;
     }
 
     d_->stylesheet_.get().parent = this;
@@ -1399,9 +1632,9 @@ std::size_t workbook::add_shared_string(const rich_text &shared, bool allow_dupl
 
 bool workbook::contains(const std::string &sheet_title) const
 {
-    for (auto ws : *this)
+    for (const auto &ws : d_->worksheets_)
     {
-        if (ws.title() == sheet_title) return true;
+        if (ws.title_ == sheet_title) return true;
     }
 
     return false;
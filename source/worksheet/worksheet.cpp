@@ -92,6 +92,8 @@ void worksheet::create_named_range(const std::string &name, const std::string &r
 
 void worksheet::create_named_range(const std::string &name, const range_reference &reference)
 {
+    d_->modified_ = true;
+
     try
     {
         auto temp = cell_reference::split_reference(name);
@@ -141,6 +143,7 @@ page_margins worksheet::page_margins() const
 
 void worksheet::page_margins(const class page_margins &margins)
 {
+    d_->modified_ = true;
     d_->page_margins_ = margins;
 }
 
@@ -151,6 +154,7 @@ void worksheet::auto_filter(const std::string &reference_string)
 
 void worksheet::auto_filter(const range_reference &reference)
 {
+    d_->modified_ = true;
     d_->auto_filter_ = reference;
 }
 
@@ -171,11 +175,13 @@ bool worksheet::has_auto_filter() const
 
 void worksheet::clear_auto_filter()
 {
+    d_->modified_ = true;
     d_->auto_filter_.clear();
 }
 
 void worksheet::page_setup(const struct page_setup &setup)
 {
+    d_->modified_ = true;
     d_->page_setup_ = setup;
 }
 
@@ -201,19 +207,12 @@ const workbook &worksheet::workbook() const
 
 void worksheet::garbage_collect()
 {
-    auto cell_iter = d_->cell_map_.begin();
+    d_->cell_map_.erase_if([](detail::cell_impl &cell) {
+        if (!xlnt::cell(&cell).garbage_collectible()) return false;
 
-    while (cell_iter != d_->cell_map_.end())
-    {
-        if (xlnt::cell(&cell_iter->second).garbage_collectible())
-        {
-            cell_iter = d_->cell_map_.erase(cell_iter);
-        }
-        else
-        {
-            ++cell_iter;
-        }
-    }
+        cell.clear_attributes();
+        return true;
+    });
 }
 
 void worksheet::id(std::size_t id)
@@ -233,6 +232,8 @@ std::string worksheet::title() const
 
 void worksheet::title(const std::string &title)
 {
+    d_->modified_ = true;
+
     // do no work if we don't need to
     if (d_->title_ == title)
     {
@@ -281,6 +282,8 @@ void worksheet::freeze_panes(xlnt::cell top_left_cell)
 
 void worksheet::freeze_panes(const cell_reference &ref)
 {
+    d_->modified_ = true;
+
     if (ref == "A1")
     {
         unfreeze_panes();
@@ -326,6 +329,8 @@ void worksheet::freeze_panes(const cell_reference &ref)
 
 void worksheet::unfreeze_panes()
 {
+    d_->modified_ = true;
+
     if (!has_view()) return;
 
     auto &primary_view = d_->views_.front();
@@ -336,6 +341,8 @@ void worksheet::unfreeze_panes()
 
 void worksheet::active_cell(const cell_reference &ref)
 {
+    d_->modified_ = true;
+
     if (!has_view())
     {
         d_->views_.push_back(sheet_view());
@@ -382,22 +389,27 @@ cell_reference worksheet::active_cell() const
 
 cell worksheet::cell(const cell_reference &reference)
 {
-    auto match = d_->cell_map_.find(reference);
-    if (match == d_->cell_map_.end())
+    auto match = d_->cell_map_.find(reference.column_index(), reference.row());
+    if (match == nullptr)
     {
         auto impl = detail::cell_impl();
         impl.parent_ = d_;
         impl.column_ = reference.column_index();
         impl.row_ = reference.row();
 
-        match = d_->cell_map_.emplace(reference, impl).first;
+        match = d_->cell_map_.emplace(std::move(impl)).first;
     }
-    return xlnt::cell(&match->second);
+    return xlnt::cell(match);
 }
 
 const cell worksheet::cell(const cell_reference &reference) const
 {
-    return xlnt::cell(&d_->cell_map_.at(reference));
+    auto match = d_->cell_map_.find(reference.column_index(), reference.row());
+    if (match == nullptr)
+    {
+        throw xlnt::key_not_found();
+    }
+    return xlnt::cell(const_cast<detail::cell_impl *>(match));
 }
 
 cell worksheet::cell(xlnt::column_t column, row_t row)
@@ -412,8 +424,7 @@ const cell worksheet::cell(xlnt::column_t column, row_t row) const
 
 bool worksheet::has_cell(const cell_reference &reference) const
 {
-    const auto cell = d_->cell_map_.find(reference);
-    return cell != d_->cell_map_.cend();
+    return d_->cell_map_.find(reference.column_index(), reference.row()) != nullptr;
 }
 
 bool worksheet::has_row_properties(row_t row) const
@@ -458,14 +469,7 @@ column_t worksheet::lowest_column() const
         return constants::min_column();
     }
 
-    auto lowest = constants::max_column();
-
-    for (auto &cell : d_->cell_map_)
-    {
-        lowest = std::min(lowest, cell.first.column());
-    }
-
-    return lowest;
+    return d_->cell_map_.lowest_column();
 }
 
 column_t worksheet::lowest_column_or_props() const
@@ -492,14 +496,7 @@ row_t worksheet::lowest_row() const
         return constants::min_row();
     }
 
-    auto lowest = constants::max_row();
-
-    for (auto &cell : d_->cell_map_)
-    {
-        lowest = std::min(lowest, cell.first.row());
-    }
-
-    return lowest;
+    return d_->cell_map_.lowest_row();
 }
 
 row_t worksheet::lowest_row_or_props() const
@@ -521,14 +518,12 @@ row_t worksheet::lowest_row_or_props() const
 
 row_t worksheet::highest_row() const
 {
-    auto highest = constants::min_row();
-
-    for (auto &cell : d_->cell_map_)
+    if (d_->cell_map_.empty())
     {
-        highest = std::max(highest, cell.first.row());
+        return constants::min_row();
     }
 
-    return highest;
+    return std::max(constants::min_row(), d_->cell_map_.highest_row());
 }
 
 row_t worksheet::highest_row_or_props() const
@@ -550,14 +545,12 @@ row_t worksheet::highest_row_or_props() const
 
 column_t worksheet::highest_column() const
 {
-    auto highest = constants::min_column();
-
-    for (auto &cell : d_->cell_map_)
+    if (d_->cell_map_.empty())
     {
-        highest = std::max(highest, cell.first.column());
+        return constants::min_column();
     }
 
-    return highest;
+    return std::max(constants::min_column(), d_->cell_map_.highest_column());
 }
 
 column_t worksheet::highest_column_or_props() const
@@ -600,19 +593,10 @@ range_reference worksheet::calculate_dimension() const
         return range_reference(constants::min_column(), min_row_prop,
             constants::min_column(), max_row_prop);
     }
-    // find min and max row/column in cell map
-    column_t min_col = constants::max_column();
-    column_t max_col = constants::min_column();
-    row_t min_row = min_row_prop;
-    row_t max_row = max_row_prop;
-    for (auto &c : d_->cell_map_)
-    {
-        min_col = std::min(min_col, c.second.column_);
-        max_col = std::max(max_col, c.second.column_);
-        min_row = std::min(min_row, c.second.row_);
-        max_row = std::max(max_row, c.second.row_);
-    }
-    return range_reference(min_col, min_row, max_col, max_row);
+    // the cell store finds its bounds without visiting every cell
+    const auto &cells = d_->cell_map_;
+    return range_reference(cells.lowest_column(), std::min(min_row_prop, cells.lowest_row()),
+        cells.highest_column(), std::max(max_row_prop, cells.highest_row()));
 }
 
 range worksheet::range(const std::string &reference_string)
@@ -657,6 +641,8 @@ void worksheet::unmerge_cells(const std::string &reference_string)
 
 void worksheet::merge_cells(const range_reference &reference)
 {
+    d_->modified_ = true;
+
     d_->merged_cells_.push_back(reference);
     bool first = true;
 
@@ -685,6 +671,8 @@ void worksheet::merge_cells(const range_reference &reference)
 
 void worksheet::unmerge_cells(const range_reference &reference)
 {
+    d_->modified_ = true;
+
     auto match = std::find(d_->merged_cells_.begin(), d_->merged_cells_.end(), reference);
 
     if (match == d_->merged_cells_.end())
@@ -753,23 +741,26 @@ const cell_vector worksheet::cells(bool skip_null) const
 
 void worksheet::clear_cell(const cell_reference &ref)
 {
-    d_->cell_map_.erase(ref);
+    d_->modified_ = true;
+
+    auto cell = d_->cell_map_.find(ref.column_index(), ref.row());
+    if (cell == nullptr) return;
+
+    cell->clear_attributes();
+    d_->cell_map_.erase(ref.column_index(), ref.row());
     // TODO: garbage collect newly unreferenced resources such as styles?
 }
 
 void worksheet::clear_row(row_t row)
 {
-    for (auto it = d_->cell_map_.begin(); it != d_->cell_map_.end();)
-    {
-        if (it->first.row() == row)
-        {
-            it = d_->cell_map_.erase(it);
-        }
-        else
-        {
-            ++it;
-        }
-    }
+    d_->modified_ = true;
+
+    d_->cell_map_.erase_if([row](detail::cell_impl &cell) {
+        if (cell.row_ != row) return false;
+
+        cell.clear_attributes();
+        return true;
+    });
     d_->row_properties_.erase(row);
     // TODO: garbage collect newly unreferenced resources such as styles?
 }
@@ -796,6 +787,8 @@ void worksheet::delete_columns(column_t column, std::uint32_t amount)
 
 void worksheet::move_cells(std::uint32_t min_index, std::uint32_t amount, row_or_col_t row_or_col, bool reverse)
 {
+    d_->modified_ = true;
+
     if (reverse && amount > min_index)
     {
         throw xlnt::invalid_parameter();
@@ -806,19 +799,28 @@ void worksheet::move_cells(std::uint32_t min_index, std::uint32_t amount, row_or
         throw xlnt::exception("Cannot move cells as they would be outside the maximum bounds of the spreadsheet");
     }
 
-    std::vector<detail::cell_impl> cells_to_move;
-
-    auto cell_iter = d_->cell_map_.cbegin();
-    while (cell_iter != d_->cell_map_.cend())
+    // the parts of the cells kept in the tables of the worksheet are keyed by
+    // position, so they're taken out and put back at the new position
+    struct moved_cell
     {
+        detail::cell_impl impl;
+        rich_text text;
+        std::string formula;
+        detail::hyperlink_impl hyperlink;
+        optional<class comment> comment;
+    };
+
+    std::vector<moved_cell> cells_to_move;
+
+    d_->cell_map_.erase_if([&](detail::cell_impl &cell) {
         std::uint32_t current_index;
         switch (row_or_col)
         {
         case row_or_col_t::row:
-            current_index = cell_iter->first.row();
+            current_index = cell.row_;
             break;
         case row_or_col_t::column:
-            current_index = cell_iter->first.column().index;
+            current_index = cell.column_.index;
             break;
         default:
             throw xlnt::unhandled_switch_case();
@@ -826,32 +828,47 @@ void worksheet::move_cells(std::uint32_t min_index, std::uint32_t amount, row_or
 
         if (current_index >= min_index) // extract cells to be moved
         {
-            auto cell = cell_iter->second;
+            moved_cell moved;
+            moved.impl = cell;
+            if (cell.has_text_) moved.text = cell.text();
+            if (cell.has_formula_) moved.formula = cell.formula();
+            if (cell.has_hyperlink_) moved.hyperlink = cell.hyperlink();
+            if (cell.has_comment_) moved.comment = cell.cell_comment();
+            cell.clear_attributes();
+
             if (row_or_col == row_or_col_t::row)
             {
-                cell.row_ = reverse ? cell.row_ - amount : cell.row_ + amount;
+                moved.impl.row_ = reverse ? cell.row_ - amount : cell.row_ + amount;
             }
             else if (row_or_col == row_or_col_t::column)
             {
-                cell.column_ = reverse ? cell.column_.index - amount : cell.column_.index + amount;
+                moved.impl.column_ = reverse ? cell.column_.index - amount : cell.column_.index + amount;
             }
 
-            cells_to_move.push_back(cell);
-            cell_iter = d_->cell_map_.erase(cell_iter);
-        }
-        else if (reverse && current_index >= min_index - amount) // delete destination cells
-        {
-            cell_iter = d_->cell_map_.erase(cell_iter);
+            cells_to_move.push_back(std::move(moved));
+            return true;
         }
-        else // skip other cells
+
+        if (reverse && current_index >= min_index - amount) // delete destination cells
         {
-            ++cell_iter;
+            cell.clear_attributes();
+            return true;
         }
-    }
 
-    for (auto &cell : cells_to_move)
+        return false; // skip other cells
+    });
+
+    for (auto &moved : cells_to_move)
     {
-        d_->cell_map_[cell_reference(cell.column_, cell.row_)] = cell;
+        auto cell = d_->cell_map_.emplace(std::move(moved.impl)).first;
+
+        if (cell->has_text_) cell->text(std::move(moved.text));
+        if (cell->has_formula_) cell->formula(std::move(moved.formula));
+        if (cell->has_hyperlink_) cell->reset_hyperlink() = std::move(moved.hyperlink);
+        if (cell->has_comment_)
+        {
+            d_->comments_[cell_reference(cell->column_, cell->row_).to_string()] = moved.comment.get();
+        }
     }
 
     if (row_or_col == row_or_col_t::row)
@@ -962,13 +979,14 @@ bool worksheet::compare(const worksheet &other, bool reference) const
 
     for (auto &cell : d_->cell_map_)
     {
-        if (other.d_->cell_map_.find(cell.first) == other.d_->cell_map_.end())
+        auto other_impl = other.d_->cell_map_.find(cell.column_, cell.row_);
+        if (other_impl == nullptr)
         {
             return false;
         }
 
-        xlnt::cell this_cell(&cell.second);
-        xlnt::cell other_cell(&other.d_->cell_map_[cell.first]);
+        xlnt::cell this_cell(const_cast<detail::cell_impl *>(&cell));
+        xlnt::cell other_cell(other_impl);
 
         if (this_cell.data_type() != other_cell.data_type())
         {
@@ -1025,6 +1043,8 @@ bool worksheet::has_named_range(const std::string &name) const
 
 void worksheet::remove_named_range(const std::string &name)
 {
+    d_->modified_ = true;
+
     if (!has_named_range(name))
     {
         throw key_not_found();
@@ -1066,6 +1086,7 @@ cell_reference worksheet::point_pos(int left, int top) const
 
 void worksheet::sheet_state(xlnt::sheet_state state)
 {
+    d_->modified_ = true;
     page_setup().sheet_state(state);
 }
 
@@ -1076,6 +1097,7 @@ sheet_state worksheet::sheet_state() const
 
 void worksheet::add_column_properties(column_t column, const xlnt::column_properties &props)
 {
+    d_->modified_ = true;
     d_->column_properties_[column] = props;
 }
 
@@ -1086,6 +1108,7 @@ bool worksheet::has_column_properties(column_t column) const
 
 column_properties &worksheet::column_properties(column_t column)
 {
+    d_->modified_ = true;
     return d_->column_properties_[column];
 }
 
@@ -1096,6 +1119,7 @@ const column_properties &worksheet::column_properties(column_t column) const
 
 row_properties &worksheet::row_properties(row_t row)
 {
+    d_->modified_ = true;
     return d_->row_properties_[row];
 }
 
@@ -1106,6 +1130,7 @@ const row_properties &worksheet::row_properties(row_t row) const
 
 void worksheet::add_row_properties(row_t row, const xlnt::row_properties &props)
 {
+    d_->modified_ = true;
     d_->row_properties_[row] = props;
 }
 
@@ -1146,6 +1171,7 @@ void worksheet::print_title_rows(row_t last_row)
 
 void worksheet::print_title_rows(row_t first_row, row_t last_row)
 {
+    d_->modified_ = true;
     d_->print_title_rows_ = std::to_string(first_row) + ":" + std::to_string(last_row);
 }
 
@@ -1156,6 +1182,7 @@ void worksheet::print_title_cols(column_t last_column)
 
 void worksheet::print_title_cols(column_t first_column, column_t last_column)
 {
+    d_->modified_ = true;
     d_->print_title_cols_ = first_column.column_string() + ":" + last_column.column_string();
 }
 
@@ -1177,6 +1204,7 @@ std::string worksheet::print_titles() const
 
 void worksheet::print_area(const std::string &print_area)
 {
+    d_->modified_ = true;
     d_->print_area_ = range_reference::make_absolute(range_reference(print_area));
 }
 
@@ -1192,11 +1220,13 @@ bool worksheet::has_view() const
 
 sheet_view &worksheet::view(std::size_t index) const
 {
+    d_->modified_ = true;
     return d_->views_.at(index);
 }
 
 void worksheet::add_view(const sheet_view &new_view)
 {
+    d_->modified_ = true;
     d_->views_.push_back(new_view);
 }
 
@@ -1222,6 +1252,7 @@ const phonetic_pr &worksheet::phonetic_properties() const
 
 void worksheet::phonetic_properties(const phonetic_pr &phonetic_props)
 {
+    d_->modified_ = true;
     d_->phonetic_properties_.set(phonetic_props);
 }
 
@@ -1232,17 +1263,21 @@ bool worksheet::has_header_footer() const
 
 void worksheet::header_footer(const class header_footer &hf)
 {
+    d_->modified_ = true;
     d_->header_footer_ = hf;
 }
 
 void worksheet::clear_page_breaks()
 {
+    d_->modified_ = true;
+
     d_->row_breaks_.clear();
     d_->column_breaks_.clear();
 }
 
 void worksheet::page_break_at_row(row_t row)
 {
+    d_->modified_ = true;
     d_->row_breaks_.push_back(row);
 }
 
@@ -1253,6 +1288,7 @@ const std::vector<row_t> &worksheet::page_break_rows() const
 
 void worksheet::page_break_at_column(xlnt::column_t column)
 {
+    d_->modified_ = true;
     d_->column_breaks_.push_back(column);
 }
 
@@ -1301,6 +1337,7 @@ void worksheet::parent(xlnt::workbook &wb)
 
 conditional_format worksheet::conditional_format(const range_reference &ref, const condition &when)
 {
+    d_->modified_ = true;
     return workbook().d_->stylesheet_.get().add_conditional_format_rule(d_, ref, when);
 }
 
@@ -1327,6 +1364,7 @@ sheet_format_properties worksheet::format_properties() const
 
 void worksheet::format_properties(const sheet_format_properties &properties)
 {
+    d_->modified_ = true;
     d_->format_properties_ = properties;
 }
 
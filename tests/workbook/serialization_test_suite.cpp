@@ -21,7 +21,9 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <fstream>
 #include <iostream>
+#include <sstream>
 
 #include <xlnt/cell/comment.hpp>
 #include <xlnt/cell/hyperlink.hpp>
@@ -37,9 +39,13 @@
 #include <xlnt/utils/time.hpp>
 #include <xlnt/utils/timedelta.hpp>
 #include <xlnt/utils/variant.hpp>
+#include <xlnt/workbook/load_options.hpp>
+#include <xlnt/workbook/save_options.hpp>
 #include <xlnt/workbook/streaming_workbook_reader.hpp>
 #include <xlnt/workbook/streaming_workbook_writer.hpp>
 #include <xlnt/workbook/workbook.hpp>
+#include <xlnt/workbook/workbook_view.hpp>
+#include <xlnt/workbook/worksheet_iterator.hpp>
 #include <xlnt/workbook/metadata_property.hpp>
 #include <xlnt/worksheet/column_properties.hpp>
 #include <xlnt/worksheet/row_properties.hpp>
@@ -47,7 +53,9 @@
 #include <xlnt/worksheet/header_footer.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
 #include <detail/cryptography/xlsx_crypto_consumer.hpp>
+#include <detail/serialization/crc32.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
+#include <detail/serialization/zstream.hpp>
 #include <helpers/path_helper.hpp>
 #include <helpers/temporary_file.hpp>
 #include <helpers/test_suite.hpp>
@@ -89,10 +97,34 @@ public:
         register_test(test_round_trip_rw_encrypted_standard);
         register_test(test_round_trip_rw_encrypted_numbers);
         register_test(test_streaming_read);
+        register_test(test_streaming_read_transient_cells);
+        register_test(test_streaming_read_rows);
         register_test(test_streaming_write);
         register_test(test_load_save_german_locale);
         register_test(test_Issue445_inline_str_load);
         register_test(test_Issue445_inline_str_streaming_read);
+        register_test(test_load_worksheets_concurrently);
+        register_test(test_load_pipelined_sheet_data);
+        register_test(test_load_prefetched_parts);
+        register_test(test_load_worksheets_lazily);
+        register_test(test_load_selected_worksheets_and_columns);
+        register_test(test_load_values_only);
+        register_test(test_load_scanned_sheet_data);
+        register_test(test_load_row_range);
+        register_test(test_write_shared_string_count);
+        register_test(test_write_sparse_rows);
+        register_test(test_save_worksheets_concurrently);
+        register_test(test_save_compressing_concurrently);
+        register_test(test_save_compression_levels);
+        register_test(test_buffer_sizes);
+        register_test(test_copy_unmodified_worksheets);
+        register_test(test_save_incremental);
+        register_test(test_load_mapped_file);
+        register_test(test_load_from_memory);
+        register_test(test_zip64_archive);
+        register_test(test_archive_part_names);
+        register_test(test_crc32);
+        register_test(test_save_to_unseekable_stream);
     }
 
     bool workbook_matches_file(xlnt::workbook &wb, const xlnt::path &file)
@@ -695,6 +727,101 @@ public:
         }
     }
 
+    void test_streaming_read_transient_cells()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (xlnt::row_t row = 1; row <= 100; ++row)
+        {
+            ws.cell(1, row).value(static_cast<int>(row));
+            ws.cell(2, row).formula("A" + std::to_string(row) + "*2");
+            ws.row_properties(row).height = static_cast<double>(row);
+            ws.row_properties(row).custom_height = true;
+        }
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::streaming_workbook_reader reader;
+        reader.open(data);
+        reader.begin_worksheet(ws.title());
+        std::size_t cells = 0;
+
+        while (reader.has_cell())
+        {
+            auto cell = reader.read_cell();
+            const auto row = cell.row();
+            xlnt_assert_equals(reader.current_row_properties().height.get(), static_cast<double>(row));
+
+            if (cell.column() == "A")
+            {
+                xlnt_assert_equals(cell.value<int>(), static_cast<int>(row));
+                xlnt_assert(!cell.has_formula());
+            }
+            else
+            {
+                // nothing is left over from the cell read before
+                xlnt_assert(!cell.has_value());
+                xlnt_assert_equals(cell.formula(), "A" + std::to_string(row) + "*2");
+            }
+
+            ++cells;
+        }
+
+        xlnt_assert_equals(cells, 200);
+
+        auto streamed = reader.end_worksheet();
+        xlnt_assert(!streamed.has_cell("A1"));
+        xlnt_assert(!streamed.has_row_properties(1));
+    }
+
+    void test_streaming_read_rows()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value(1.5);
+        ws.cell("B1").value("text");
+        ws.cell("C1").value(true);
+        ws.row_properties(2).height = 20.0; // a row without cells
+        ws.cell("B3").value("more");
+        ws.cell("A4").value(4);
+        ws.cell("A5").value(5);
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::streaming_workbook_reader reader;
+        reader.open(data);
+        reader.begin_worksheet(ws.title());
+
+        const auto &first = reader.read_rows(2);
+        xlnt_assert_equals(first.row_count, 2);
+        xlnt_assert_equals(first.size(), 3);
+        xlnt_assert_equals(first.rows, std::vector<xlnt::row_t>({1, 1, 1}));
+        xlnt_assert_equals(first.columns, std::vector<xlnt::column_t::index_t>({1, 2, 3}));
+        xlnt_assert(first.types[0] == xlnt::cell::type::number);
+        xlnt_assert_equals(first.numbers[0], 1.5);
+        xlnt_assert(first.types[1] == xlnt::cell::type::shared_string);
+        xlnt_assert_equals(first.string(1), "text");
+        xlnt_assert(first.types[2] == xlnt::cell::type::boolean);
+        xlnt_assert_equals(first.numbers[2], 1.0);
+        xlnt_assert_equals(first.string(2), "");
+
+        // the batch is reused
+        const auto &second = reader.read_rows(2);
+        xlnt_assert_equals(&second, &first);
+        xlnt_assert_equals(second.row_count, 2);
+        xlnt_assert_equals(second.rows, std::vector<xlnt::row_t>({3, 4}));
+        xlnt_assert_equals(second.string(0), "more");
+        xlnt_assert_equals(second.string_data, "more");
+        xlnt_assert_equals(second.numbers[1], 4.0);
+
+        xlnt_assert_equals(reader.read_rows(10).rows, std::vector<xlnt::row_t>({5}));
+        xlnt_assert_equals(reader.read_rows(10).size(), 0);
+        reader.end_worksheet();
+    }
+
     void test_streaming_write()
     {
         const auto path = std::string("stream-out.xlsx");
@@ -736,5 +863,1225 @@ public:
         auto cell = wbr.read_cell();
         xlnt_assert_equals(cell.value<std::string>(), std::string("a"));
     }
+
+    void test_load_worksheets_concurrently()
+    {
+        xlnt::load_options options;
+        options.worksheet_threads = 4;
+
+        for (const auto &file : {"10_comments_hyperlinks_formulae.xlsx", "Issue279_workbook_delete_rename.xlsx"})
+        {
+            xlnt::workbook serial;
+            serial.load(path_helper::test_file(file));
+            std::vector<std::uint8_t> serial_data;
+            serial.save(serial_data);
+
+            xlnt::workbook concurrent;
+            concurrent.load(path_helper::test_file(file), options);
+            std::vector<std::uint8_t> concurrent_data;
+            concurrent.save(concurrent_data);
+
+            xlnt_assert(xml_helper::xlsx_archives_match(serial_data, concurrent_data));
+        }
+
+        xlnt::workbook wb;
+
+        for (auto i = 1; i < 16; ++i)
+        {
+            auto ws = wb.create_sheet();
+
+            for (auto row = 1u; row <= 100; ++row)
+            {
+                ws.cell(xlnt::cell_reference(1, row)).value(i * 1000 + static_cast<int>(row));
+                ws.cell(xlnt::cell_reference(2, row)).value(ws.title());
+            }
+        }
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::workbook loaded;
+        loaded.load(data, options);
+
+        xlnt_assert_equals(loaded.sheet_count(), wb.sheet_count());
+        xlnt_assert_equals(loaded.sheet_by_index(15).cell("A100").value<int>(), 15100);
+        xlnt_assert_equals(loaded.sheet_by_index(7).cell("B1").value<std::string>(), wb.sheet_by_index(7).title());
+    }
+
+    void test_load_pipelined_sheet_data()
+    {
+        xlnt::load_options options;
+        options.pipeline_sheet_data = true;
+
+        for (const auto &file : {"4_every_style.xlsx", "10_comments_hyperlinks_formulae.xlsx", "15_phonetics.xlsx"})
+        {
+            xlnt::workbook serial;
+            serial.load(path_helper::test_file(file));
+            std::vector<std::uint8_t> serial_data;
+            serial.save(serial_data);
+
+            xlnt::workbook pipelined;
+            pipelined.load(path_helper::test_file(file), options);
+            std::vector<std::uint8_t> pipelined_data;
+            pipelined.save(pipelined_data);
+
+            xlnt_assert(xml_helper::xlsx_archives_match(serial_data, pipelined_data));
+        }
+
+        // enough cells for several chunks to be queued
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (auto row = 1u; row <= 5000; ++row)
+        {
+            for (auto column = 1u; column <= 5; ++column)
+            {
+                ws.cell(xlnt::cell_reference(column, row)).value(static_cast<int>(row * column));
+            }
+        }
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::workbook loaded;
+        loaded.load(data, options);
+
+        xlnt_assert_equals(loaded.active_sheet().calculate_dimension(), xlnt::range_reference("A1:E5000"));
+        xlnt_assert_equals(loaded.active_sheet().cell("C4321").value<int>(), 4321 * 3);
+    }
+
+    void test_load_prefetched_parts()
+    {
+        xlnt::load_options options;
+        options.prefetch_threads = 2;
+
+        for (const auto &file : {"4_every_style.xlsx", "10_comments_hyperlinks_formulae.xlsx", "15_phonetics.xlsx"})
+        {
+            xlnt::workbook serial;
+            serial.load(path_helper::test_file(file));
+            std::vector<std::uint8_t> serial_data;
+            serial.save(serial_data);
+
+            xlnt::workbook prefetched;
+            prefetched.load(path_helper::test_file(file), options);
+            std::vector<std::uint8_t> prefetched_data;
+            prefetched.save(prefetched_data);
+
+            xlnt_assert(xml_helper::xlsx_archives_match(serial_data, prefetched_data));
+        }
+
+        xlnt::workbook wb;
+
+        for (auto i = 1; i < 8; ++i)
+        {
+            auto ws = wb.create_sheet();
+
+            for (auto row = 1u; row <= 1000; ++row)
+            {
+                ws.cell(xlnt::cell_reference(1, row)).value(i * 10000 + static_cast<int>(row));
+            }
+        }
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        // a budget of a few worksheets makes the threads wait for parts to be read,
+        // and one of no bytes leaves every part to be read as usual
+        for (auto memory : {std::size_t(100000), std::size_t(0)})
+        {
+            for (auto worksheet_threads : {std::size_t(1), std::size_t(3)})
+            {
+                options.prefetch_memory = memory;
+                options.worksheet_threads = worksheet_threads;
+
+                xlnt::workbook loaded;
+                loaded.load(data, options);
+                xlnt_assert_equals(loaded.sheet_count(), wb.sheet_count());
+                xlnt_assert_equals(loaded.sheet_by_index(7).cell("A1000").value<int>(), 71000);
+                xlnt_assert_equals(loaded.sheet_by_index(3).cell("A1").value<int>(), 30001);
+            }
+        }
+
+        // worksheets left out by worksheet_titles are never inflated, so they don't take up the budget
+        {
+            // records where the package is read from, a small block at a time
+            class recording_streambuf : public std::streambuf
+            {
+            public:
+                recording_streambuf(const std::vector<std::uint8_t> &data)
+                    : data_(data)
+                {
+                }
+
+                std::vector<std::size_t> reads;
+
+            protected:
+                int_type underflow()
+                {
+                    if (position_ >= data_.size())
+                    {
+                        return traits_type::eof();
+                    }
+
+                    reads.push_back(position_);
+                    const auto begin = reinterpret_cast<char *>(const_cast<std::uint8_t *>(data_.data())) + position_;
+                    const auto count = std::min(std::size_t(512), data_.size() - position_);
+                    setg(begin, begin, begin + count);
+                    position_ += count;
+
+                    return traits_type::to_int_type(*gptr());
+                }
+
+                std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode)
+                {
+                    const auto current = static_cast<std::streamoff>(position_) - (egptr() - gptr());
+                    const auto base = way == std::ios_base::beg ? 0
+                        : way == std::ios_base::cur ? current : static_cast<std::streamoff>(data_.size());
+
+                    return seekpos(base + off, std::ios_base::in);
+                }
+
+                std::streampos seekpos(std::streampos sp, std::ios_base::openmode)
+                {
+                    position_ = static_cast<std::size_t>(sp);
+                    setg(nullptr, nullptr, nullptr);
+
+                    return sp;
+                }
+
+            private:
+                const std::vector<std::uint8_t> &data_;
+                std::size_t position_ = 0;
+            };
+
+            xlnt::workbook titles_wb;
+            titles_wb.active_sheet().title("kept");
+            titles_wb.active_sheet().cell("A1").value(1);
+            auto excluded = titles_wb.create_sheet();
+            excluded.title("excluded");
+
+            for (auto row = 1u; row <= 20000; ++row)
+            {
+                excluded.cell(xlnt::cell_reference(1, row)).value(static_cast<int>(row * 7919 % 10007));
+            }
+
+            std::vector<std::uint8_t> titles_data;
+            titles_wb.save(titles_data);
+
+            // the data of the excluded worksheet is between its local header and the next one,
+            // or the central directory
+            const auto bytes = std::string(titles_data.begin(), titles_data.end());
+            const auto excluded_header = bytes.find("PK\x03\x04");
+            auto excluded_start = std::string::npos;
+
+            for (auto header = excluded_header; header != std::string::npos; header = bytes.find("PK\x03\x04", header + 4))
+            {
+                if (bytes.compare(header + 30, 24, "xl/worksheets/sheet2.xml") == 0)
+                {
+                    excluded_start = header + 30 + 24;
+                    break;
+                }
+            }
+
+            xlnt_assert_differs(excluded_start, std::string::npos);
+            const auto excluded_end = std::min(bytes.find("PK\x03\x04", excluded_start), bytes.find("PK\x01\x02"));
+            xlnt_assert(excluded_end - excluded_start > 4096);
+
+            xlnt::load_options titles_options;
+            titles_options.prefetch_threads = 2;
+            titles_options.worksheet_titles.insert("kept");
+
+            recording_streambuf recording(titles_data);
+            std::istream recording_stream(&recording);
+            xlnt::workbook loaded;
+            loaded.load(recording_stream, titles_options);
+            xlnt_assert_equals(loaded.sheet_by_title("kept").cell("A1").value<int>(), 1);
+
+            // the block read before the excluded data may reach into it, and the end of
+            // central directory record is looked for in the last 64 KiB of the package
+            xlnt_assert(excluded_start + 4096 < bytes.size() - 65557);
+
+            for (auto read : recording.reads)
+            {
+                xlnt_assert(read < excluded_start + 512 || read >= excluded_end || read >= bytes.size() - 65557);
+            }
+        }
+
+        // files opened twice, files larger than the budget and files that aren't prefetched
+        std::vector<std::uint8_t> archive_data;
+
+        {
+            xlnt::detail::vector_ostreambuf buffer(archive_data);
+            std::ostream stream(&buffer);
+            xlnt::detail::ozstream archive(stream);
+            std::ostream(archive.open(xlnt::path("small.txt")).get()) << "small";
+            std::ostream(archive.open(xlnt::path("large.txt")).get()) << std::string(1000, 'l');
+            std::ostream(archive.open(xlnt::path("other.txt")).get()) << "other";
+        }
+
+        xlnt::detail::izstream archive(archive_data.data(), archive_data.size());
+        archive.prefetch({xlnt::path("small.txt"), xlnt::path("large.txt"), xlnt::path("missing.txt")}, 2, 100);
+
+        for (auto i = 0; i < 2; ++i)
+        {
+            std::ostringstream small, large, other;
+            small << archive.open(xlnt::path("small.txt")).get();
+            large << archive.open(xlnt::path("large.txt")).get();
+            other << archive.open(xlnt::path("other.txt")).get();
+            xlnt_assert_equals(small.str(), "small");
+            xlnt_assert_equals(large.str(), std::string(1000, 'l'));
+            xlnt_assert_equals(other.str(), "other");
+        }
+
+        archive.stop_prefetch();
+        xlnt_assert_equals(archive.read(xlnt::path("small.txt")), "small");
+    }
+
+    void test_load_worksheets_lazily()
+    {
+        xlnt::load_options options;
+        options.lazy_worksheets = true;
+
+        for (const auto &file : {"10_comments_hyperlinks_formulae.xlsx", "Issue279_workbook_delete_rename.xlsx"})
+        {
+            xlnt::workbook eager;
+            eager.load(path_helper::test_file(file));
+            std::vector<std::uint8_t> eager_data;
+            eager.save(eager_data);
+
+            xlnt::workbook lazy;
+            lazy.load(path_helper::test_file(file), options);
+            std::vector<std::uint8_t> lazy_data;
+            lazy.save(lazy_data);
+
+            xlnt_assert(xml_helper::xlsx_archives_match(eager_data, lazy_data));
+        }
+
+        // worksheets are still read after the loaded data is gone and relationships are renumbered
+        xlnt::workbook wb;
+        wb.active_sheet().title("first");
+        wb.active_sheet().cell("A1").value("first");
+
+        for (const auto &title : {"second", "third", "fourth"})
+        {
+            auto ws = wb.create_sheet();
+            ws.title(title);
+            ws.cell("B2").value(title);
+        }
+
+        xlnt::workbook lazy;
+
+        {
+            std::vector<std::uint8_t> data;
+            wb.save(data);
+            lazy.load(data, options);
+        }
+
+        lazy.remove_sheet(lazy.sheet_by_title("second"));
+        lazy.create_sheet(0).title("new");
+        lazy.sheet_by_title("first").title("renamed");
+
+        xlnt_assert_equals(lazy.sheet_count(), 4);
+        xlnt_assert_equals(lazy.sheet_by_title("third").cell("B2").value<std::string>(), "third");
+        xlnt_assert_equals(lazy.sheet_by_index(3).cell("B2").value<std::string>(), "fourth");
+        xlnt_assert_equals(lazy.sheet_by_title("renamed").cell("A1").value<std::string>(), "first");
+    }
+
+    void test_load_selected_worksheets_and_columns()
+    {
+        xlnt::workbook wb;
+        wb.active_sheet().title("first");
+        wb.create_sheet().title("second");
+        wb.create_sheet().title("third");
+
+        for (const auto &title : wb.sheet_titles())
+        {
+            auto ws = wb.sheet_by_title(title);
+
+            for (auto row = 1u; row <= 10; ++row)
+            {
+                for (auto column = 1u; column <= 10; ++column)
+                {
+                    ws.cell(xlnt::cell_reference(column, row)).value(static_cast<int>(row * column));
+                }
+            }
+        }
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::load_options options;
+        options.worksheet_titles = {"first", "third"};
+        options.keep_columns("first", "B", "D");
+        options.worksheet_columns["first"].push_back("H");
+
+        xlnt::workbook loaded;
+        loaded.load(data, options);
+
+        xlnt_assert_equals(loaded.sheet_count(), 2);
+        xlnt_assert(!loaded.contains("second"));
+
+        auto first = loaded.sheet_by_title("first");
+        xlnt_assert_equals(first.calculate_dimension(), xlnt::range_reference("B1:H10"));
+        xlnt_assert(!first.has_cell("A1"));
+        xlnt_assert(!first.has_cell("E5"));
+        xlnt_assert_equals(first.cell("C4").value<int>(), 12);
+        xlnt_assert_equals(first.cell("H10").value<int>(), 80);
+
+        auto third = loaded.sheet_by_title("third");
+        xlnt_assert_equals(third.calculate_dimension(), xlnt::range_reference("A1:J10"));
+        xlnt_assert_equals(third.cell("J10").value<int>(), 100);
+
+        // the reduced workbook is still a valid package
+        std::vector<std::uint8_t> reduced_data;
+        loaded.save(reduced_data);
+        xlnt::workbook reloaded;
+        reloaded.load(reduced_data);
+        xlnt_assert_equals(reloaded.sheet_titles(), std::vector<std::string>({"first", "third"}));
+        xlnt_assert_equals(reloaded.sheet_by_title("first").cell("D2").value<int>(), 8);
+
+        xlnt::load_options invalid;
+        xlnt_assert_throws(invalid.keep_columns("first", "D", "B"), xlnt::invalid_parameter);
+        xlnt_assert_throws(invalid.keep_columns("first", 0u, 2u), xlnt::invalid_parameter);
+        xlnt_assert(invalid.worksheet_columns.empty());
+    }
+
+    void test_load_values_only()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value("bold");
+        ws.cell("A1").font(xlnt::font().bold(true));
+        ws.cell("A2").value(xlnt::date(2020, 2, 29));
+        ws.cell("A3").value(0.5);
+        ws.cell("A3").number_format(xlnt::number_format("hh:mm"));
+        ws.cell("A4").value(1.5);
+        ws.cell("A4").number_format(xlnt::number_format::percentage());
+        ws.cell("A5").value(xlnt::datetime(2020, 2, 29, 12, 0));
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::load_options options;
+        options.values_only = true;
+
+        xlnt::workbook loaded;
+        loaded.load(data, options);
+        auto loaded_ws = loaded.active_sheet();
+
+        xlnt_assert_equals(loaded_ws.cell("A1").value<std::string>(), "bold");
+        xlnt_assert(!loaded_ws.cell("A1").has_format());
+        xlnt_assert(!loaded_ws.cell("A4").has_format());
+        xlnt_assert_equals(loaded_ws.cell("A4").value<double>(), 1.5);
+
+        xlnt_assert(loaded_ws.cell("A2").is_date());
+        xlnt_assert_equals(loaded_ws.cell("A2").value<xlnt::date>(), xlnt::date(2020, 2, 29));
+        xlnt_assert(loaded_ws.cell("A3").is_date());
+        xlnt_assert_equals(loaded_ws.cell("A3").number_format().format_string(), "hh:mm");
+        xlnt_assert_equals(loaded_ws.cell("A5").value<xlnt::datetime>(), xlnt::datetime(2020, 2, 29, 12, 0));
+
+        std::vector<std::uint8_t> saved;
+        xlnt_assert_throws(loaded.save(saved), xlnt::exception);
+
+        xlnt::workbook commented;
+        commented.load(path_helper::test_file("10_comments_hyperlinks_formulae.xlsx"), options);
+        xlnt_assert_equals(commented.active_sheet().cell("A1").value<std::string>(), "Sheet1!A1");
+        xlnt_assert(!commented.active_sheet().cell("A1").has_comment());
+    }
+
+    void test_load_scanned_sheet_data()
+    {
+        xlnt::workbook wb;
+        wb.active_sheet().cell("A1").value(1);
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        // the third row has a cell child the sheetData scanner doesn't know,
+        // it and the rows after it are read by the XML parser
+        const auto sheet_xml = std::string(
+            "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\"?>\n"
+            "<worksheet xmlns=\"http://schemas.openxmlformats.org/spreadsheetml/2006/main\""
+            " xmlns:x14ac=\"http://schemas.microsoft.com/office/spreadsheetml/2009/9/ac\">"
+            "<sheetData>\n"
+            "  <row r=\"1\" spans=\"1:5\" x14ac:dyDescent=\"0.25\">\n"
+            "    <c r=\"A1\" t=\"inlineStr\"><is><t>a &amp; b &lt;&#x263A;&#65;&gt;</t></is></c>\n"
+            "    <c r=\"B1\"><f>SUM(C1:E1)</f><v>3</v></c>\n"
+            "    <c r=\"C1\" s='0'><v>1.5</v></c>\n"
+            "    <c r=\"D1\"/>\n"
+            "    <c r=\"E1\" t=\"b\"><v>1</v></c>\n"
+            "  </row>\n"
+            "  <row r=\"2\" ht=\"30\" customHeight=\"1\"><c r=\"A2\" t=\"str\"><f>\"x\"</f><v>x</v></c></row>\n"
+            "  <row r=\"3\"><c r=\"A3\"><v>3</v><extLst/></c></row>\n"
+            "  <row r=\"4\"><c r=\"A4\" t=\"inlineStr\"><is><t>after &amp; fallback</t></is></c></row>\n"
+            "  <row r=\"5\"/>\n"
+            "</sheetData>"
+            "<pageMargins left=\"0.7\" right=\"0.7\" top=\"0.75\" bottom=\"0.75\" header=\"0.3\" footer=\"0.3\"/>"
+            "</worksheet>");
+
+        std::vector<std::uint8_t> modified;
+        {
+            xlnt::detail::vector_istreambuf source_buffer(data);
+            std::istream source_stream(&source_buffer);
+            xlnt::detail::izstream source(source_stream);
+            xlnt::detail::vector_ostreambuf destination_buffer(modified);
+            std::ostream destination_stream(&destination_buffer);
+            xlnt::detail::ozstream destination(destination_stream);
+
+            for (const auto &file : source.files())
+            {
+                auto file_buffer = destination.open(file);
+                std::ostream file_stream(file_buffer.get());
+                file_stream << (file.string() == "xl/worksheets/sheet1.xml" ? sheet_xml : source.read(file));
+            }
+        }
+
+        // the part is scanned from a window which is smaller than the part or even a row
+        for (auto buffer_size : {std::size_t(16), std::size_t(64), std::size_t(65536)})
+        {
+            for (auto pipeline : {false, true})
+            {
+                xlnt::load_options options;
+                options.buffer_size = buffer_size;
+                options.pipeline_sheet_data = pipeline;
+
+                xlnt::workbook loaded;
+                loaded.load(modified, options);
+                auto ws = loaded.active_sheet();
+
+                xlnt_assert_equals(ws.cell("A1").value<std::string>(), "a & b <\xE2\x98\xBA" "A>");
+                xlnt_assert_equals(ws.cell("B1").formula(), "SUM(C1:E1)");
+                xlnt_assert_equals(ws.cell("B1").value<int>(), 3);
+                xlnt_assert_equals(ws.cell("C1").value<double>(), 1.5);
+                xlnt_assert(ws.cell("C1").has_format());
+                xlnt_assert(ws.has_cell("D1"));
+                xlnt_assert_equals(ws.cell("E1").value<bool>(), true);
+                xlnt_assert_equals(ws.row_properties(1).spans.get(), "1:5");
+                xlnt_assert_equals(ws.row_properties(1).dy_descent.get(), 0.25);
+                xlnt_assert_equals(ws.cell("A2").value<std::string>(), "x");
+                xlnt_assert_equals(ws.row_properties(2).height.get(), 30.0);
+                xlnt_assert(ws.row_properties(2).custom_height);
+                xlnt_assert_equals(ws.cell("A3").value<int>(), 3);
+                xlnt_assert_equals(ws.cell("A4").value<std::string>(), "after & fallback");
+                xlnt_assert(ws.has_row_properties(5));
+            }
+        }
+    }
+
+    void test_load_row_range()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.title("rows");
+
+        for (xlnt::row_t row = 1; row <= 2000; ++row)
+        {
+            for (xlnt::column_t::index_t column = 1; column <= 3; ++column)
+            {
+                ws.cell(column, row).value(static_cast<int>(row * 10 + column));
+            }
+        }
+
+        ws.merge_cells("A1:B1");
+        wb.create_sheet().title("other");
+        wb.sheet_by_title("other").cell("A5").value(5);
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        for (auto threads : {std::size_t(1), std::size_t(2)})
+        {
+            xlnt::load_options options;
+            options.worksheet_threads = threads;
+            options.keep_rows("rows", 100, 150);
+
+            xlnt::workbook loaded;
+            loaded.load(data, options);
+
+            auto loaded_ws = loaded.sheet_by_title("rows");
+            xlnt_assert_equals(loaded_ws.calculate_dimension(), xlnt::range_reference("A100:C150"));
+            xlnt_assert_equals(loaded_ws.cell("C150").value<int>(), 1503);
+            xlnt_assert(loaded_ws.merged_ranges().empty());
+            xlnt_assert_equals(loaded.sheet_by_title("other").cell("A5").value<int>(), 5);
+        }
+
+        xlnt::load_options options;
+        xlnt_assert_throws(options.keep_rows("rows", 10, 9), xlnt::invalid_parameter);
+        xlnt_assert_throws(options.keep_columns("rows", "C", "A"), xlnt::invalid_parameter);
+
+        xlnt::streaming_workbook_reader reader;
+        reader.open(data);
+        reader.begin_worksheet("rows", 1999, 2000);
+        std::vector<int> values;
+
+        while (reader.has_cell())
+        {
+            auto cell = reader.read_cell();
+            values.push_back(cell.value<int>());
+        }
+
+        xlnt_assert_equals(values, std::vector<int>({19991, 19992, 19993, 20001, 20002, 20003}));
+        reader.end_worksheet();
+
+        reader.begin_worksheet("rows", 2, 3);
+        values.clear();
+
+        while (reader.has_cell())
+        {
+            values.push_back(reader.read_cell().value<int>());
+        }
+
+        xlnt_assert_equals(values, std::vector<int>({21, 22, 23, 31, 32, 33}));
+        reader.end_worksheet();
+    }
+
+    void test_write_shared_string_count()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value("repeated");
+        ws.cell("XFD1048576").value("repeated");
+        ws.cell("B2").value(2);
+        wb.create_sheet().cell("C3").value("other");
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::detail::vector_istreambuf buffer(data);
+        std::istream stream(&buffer);
+        xlnt::detail::izstream archive(stream);
+        const auto shared_strings = archive.read(xlnt::path("xl/sharedStrings.xml"));
+
+        xlnt_assert_differs(shared_strings.find("count=\"3\""), std::string::npos);
+        xlnt_assert_differs(shared_strings.find("uniqueCount=\"2\""), std::string::npos);
+    }
+
+    void test_write_sparse_rows()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        auto format = wb.create_format().number_format(xlnt::number_format::percentage(), true);
+
+        ws.cell("A1").value(1);
+        ws.cell("C5").value("five");
+        ws.cell("B17").value(17);
+        ws.cell("D17").format(format);
+        ws.row_properties(40).height = 30.0;
+        ws.row_properties(40).custom_height = true;
+        ws.cell("A99999").value(99999);
+        ws.cell("XFD100000").value(100000);
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::detail::vector_istreambuf buffer(data);
+        std::istream stream(&buffer);
+        xlnt::detail::izstream archive(stream);
+        const auto sheet = archive.read(xlnt::path("xl/worksheets/sheet1.xml"));
+
+        // spans cover the cells of each block of 16 rows
+        xlnt_assert_differs(sheet.find("<row r=\"1\" spans=\"1:3\">"), std::string::npos);
+        xlnt_assert_differs(sheet.find("<row r=\"5\" spans=\"1:3\">"), std::string::npos);
+        xlnt_assert_differs(sheet.find("<row r=\"17\" spans=\"2:4\">"), std::string::npos);
+        xlnt_assert_differs(sheet.find("<row r=\"40\" ht=\"30\" customHeight=\"1\""), std::string::npos);
+        xlnt_assert_differs(sheet.find("<row r=\"99999\" spans=\"1:16384\">"), std::string::npos);
+        xlnt_assert_differs(sheet.find("<row r=\"100000\" spans=\"1:16384\">"), std::string::npos);
+        xlnt_assert_equals(sheet.find("<row r=\"2\""), std::string::npos);
+        xlnt_assert(sheet.find("<row r=\"17\"") < sheet.find("<row r=\"40\"")
+            && sheet.find("<row r=\"40\"") < sheet.find("<row r=\"99999\""));
+
+        xlnt::workbook loaded;
+        loaded.load(data);
+        std::vector<std::uint8_t> resaved;
+        loaded.save(resaved);
+        xlnt::workbook reloaded;
+        reloaded.load(resaved);
+
+        // the rows are written the same way again
+        xlnt::detail::vector_istreambuf resaved_buffer(resaved);
+        std::istream resaved_stream(&resaved_buffer);
+        xlnt::detail::izstream resaved_archive(resaved_stream);
+        const auto resaved_sheet = resaved_archive.read(xlnt::path("xl/worksheets/sheet1.xml"));
+        const auto sheet_data = [](const std::string &xml) {
+            const auto begin = xml.find("<sheetData>");
+            return xml.substr(begin, xml.find("</sheetData>") - begin);
+        };
+        xlnt_assert_equals(sheet_data(resaved_sheet), sheet_data(sheet));
+
+        for (auto wb_loaded : {&loaded, &reloaded})
+        {
+            auto loaded_ws = wb_loaded->active_sheet();
+
+            xlnt_assert_equals(loaded_ws.calculate_dimension(), xlnt::range_reference("A1:XFD100000"));
+            xlnt_assert_equals(loaded_ws.cell("A1").value<int>(), 1);
+            xlnt_assert_equals(loaded_ws.cell("C5").value<std::string>(), "five");
+            xlnt_assert_equals(loaded_ws.cell("B17").value<int>(), 17);
+            xlnt_assert(!loaded_ws.cell("D17").has_value());
+            xlnt_assert_equals(loaded_ws.cell("D17").number_format(), xlnt::number_format::percentage());
+            xlnt_assert_equals(loaded_ws.row_properties(40).height.get(), 30.0);
+            xlnt_assert(!loaded_ws.has_cell("A40"));
+            xlnt_assert_equals(loaded_ws.cell("A99999").value<int>(), 99999);
+            xlnt_assert_equals(loaded_ws.cell("XFD100000").value<int>(), 100000);
+        }
+    }
+
+    void test_save_worksheets_concurrently()
+    {
+        xlnt::save_options options;
+        options.worksheet_threads = 4;
+
+        for (const auto &file : {"10_comments_hyperlinks_formulae.xlsx", "14_images.xlsx", "Issue279_workbook_delete_rename.xlsx"})
+        {
+            xlnt::workbook wb;
+            wb.load(path_helper::test_file(file));
+
+            std::vector<std::uint8_t> serial_data;
+            wb.save(serial_data);
+            std::vector<std::uint8_t> concurrent_data;
+            wb.save(concurrent_data, options);
+
+            xlnt_assert(serial_data == concurrent_data);
+        }
+
+        xlnt::workbook wb;
+
+        for (auto i = 1; i < 16; ++i)
+        {
+            auto ws = wb.create_sheet();
+
+            for (auto row = 1u; row <= 100; ++row)
+            {
+                ws.cell(xlnt::cell_reference(1, row)).value(i * 1000 + static_cast<int>(row));
+                ws.cell(xlnt::cell_reference(2, row)).value(ws.title());
+            }
+        }
+
+        std::vector<std::uint8_t> data;
+        wb.save(data, options);
+
+        xlnt::workbook loaded;
+        loaded.load(data);
+
+        xlnt_assert_equals(loaded.sheet_count(), wb.sheet_count());
+        xlnt_assert_equals(loaded.sheet_by_index(15).cell("A100").value<int>(), 15100);
+        xlnt_assert_equals(loaded.sheet_by_index(7).cell("B1").value<std::string>(), wb.sheet_by_index(7).title());
+    }
+
+    void test_save_compressing_concurrently()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        // a worksheet part of a few blocks
+        for (auto row = 1u; row <= 20000; ++row)
+        {
+            ws.cell(xlnt::cell_reference(1, row)).value(static_cast<int>(row));
+            ws.cell(xlnt::cell_reference(2, row)).value(static_cast<int>(row) * 0.5);
+        }
+
+        xlnt::save_options options;
+        options.compression_threads = 3;
+
+        std::vector<std::uint8_t> data;
+        wb.save(data, options);
+
+        xlnt::workbook loaded;
+        loaded.load(data);
+
+        auto loaded_ws = loaded.active_sheet();
+        xlnt_assert_equals(loaded_ws.calculate_dimension(), xlnt::range_reference("A1:B20000"));
+        xlnt_assert_equals(loaded_ws.cell("A1").value<int>(), 1);
+        xlnt_assert_equals(loaded_ws.cell("A12345").value<int>(), 12345);
+        xlnt_assert_equals(loaded_ws.cell("B20000").value<double>(), 10000.0);
+
+        // fails to write a compressed block, which the other writes are too small to be
+        class failing_streambuf : public std::stringbuf
+        {
+        protected:
+            std::streamsize xsputn(const char *s, std::streamsize n)
+            {
+                if (n > 512)
+                {
+                    throw std::runtime_error("block not written");
+                }
+
+                return std::stringbuf::xsputn(s, n);
+            }
+        };
+
+        // with fewer blocks than threads, every block is only written once its part is finished
+        xlnt::workbook small_wb;
+        small_wb.active_sheet().cell("A1").value(1);
+        options.compression_threads = 4;
+
+        failing_streambuf failing_buffer;
+        std::ostream failing_stream(&failing_buffer);
+        failing_stream.exceptions(std::ios::badbit);
+        xlnt_assert_throws(small_wb.save(failing_stream, options), std::runtime_error);
+    }
+
+    void test_save_compression_levels()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (auto row = 1u; row <= 1000; ++row)
+        {
+            ws.cell(xlnt::cell_reference(1, row)).value(static_cast<int>(row % 7));
+            ws.cell(xlnt::cell_reference(2, row)).value("text");
+        }
+
+        auto save = [&wb](const xlnt::save_options &options) {
+            std::vector<std::uint8_t> data;
+            wb.save(data, options);
+
+            xlnt::workbook loaded;
+            loaded.load(data);
+            xlnt_assert_equals(loaded.active_sheet().cell("A1000").value<int>(), 6);
+            xlnt_assert_equals(loaded.active_sheet().cell("B1000").value<std::string>(), "text");
+
+            return std::string(data.begin(), data.end());
+        };
+
+        xlnt::save_options options;
+        options.compression_level = 1;
+        const auto fastest = save(options);
+        options.compression_level = 9;
+        const auto smallest = save(options);
+        xlnt_assert(smallest.size() <= fastest.size());
+
+        options.compression_level = 0;
+        const auto stored = save(options);
+        xlnt_assert(stored.size() > fastest.size());
+        xlnt_assert_differs(stored.find("<sheetData>"), std::string::npos);
+        xlnt_assert_differs(stored.find("<styleSheet"), std::string::npos);
+
+        options.compression_level = 6;
+        options.part_compression_levels["xl/worksheets/sheet1.xml"] = 0;
+        const auto sheet_stored = save(options);
+        xlnt_assert_differs(sheet_stored.find("<sheetData>"), std::string::npos);
+        xlnt_assert_equals(sheet_stored.find("<styleSheet"), std::string::npos);
+
+        options.compression_level = 10;
+        std::vector<std::uint8_t> data;
+        xlnt_assert_throws(wb.save(data, options), xlnt::invalid_parameter);
+    }
+
+    void test_buffer_sizes()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (auto row = 1u; row <= 1000; ++row)
+        {
+            ws.cell(xlnt::cell_reference(1, row)).value(static_cast<int>(row));
+        }
+
+        for (auto buffer_size : {std::size_t(16), std::size_t(1024 * 1024)})
+        {
+            xlnt::save_options save_options;
+            save_options.buffer_size = buffer_size;
+            std::vector<std::uint8_t> data;
+            wb.save(data, save_options);
+
+            xlnt::load_options load_options;
+            load_options.buffer_size = buffer_size;
+            xlnt::workbook loaded;
+            loaded.load(data, load_options);
+            xlnt_assert_equals(loaded.active_sheet().cell("A1000").value<int>(), 1000);
+
+            // read a few bytes at a time rather than the whole part at once
+            load_options.keep_rows("Sheet1", 1, 999);
+            loaded.load(data, load_options);
+            xlnt_assert_equals(loaded.active_sheet().cell("A999").value<int>(), 999);
+        }
+
+        xlnt::load_options options;
+        options.buffer_size = 1;
+        xlnt::workbook loaded;
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+        xlnt_assert_throws(loaded.load(data, options), xlnt::invalid_parameter);
+    }
+
+    void test_copy_unmodified_worksheets()
+    {
+        xlnt::workbook wb;
+        auto first = wb.active_sheet();
+        first.title("First");
+        first.cell("A1").value("kept");
+        first.cell("B2").value(42);
+        first.cell("A1").comment(xlnt::comment("unchanged note", "author"));
+        auto second = wb.create_sheet();
+        second.title("Second");
+        second.cell("A1").value("old");
+
+        // stored uncompressed so a copied worksheet can be found in the saved bytes
+        xlnt::save_options save_options;
+        save_options.compression_level = 0;
+        std::vector<std::uint8_t> original;
+        wb.save(original, save_options);
+
+        const auto contains = [](const std::vector<std::uint8_t> &data, const std::string &text) {
+            return std::search(data.begin(), data.end(), text.begin(), text.end()) != data.end();
+        };
+
+        xlnt::load_options load_options;
+        load_options.copy_unmodified_worksheets = true;
+        xlnt::workbook loaded;
+        loaded.load(original, load_options);
+        xlnt_assert(loaded.contains("First"));
+        loaded.sheet_by_title("Second").cell("A1").value("new");
+
+        // reading a worksheet through handles doesn't stop it being copied
+        xlnt_assert_equals(loaded.sheet_by_title("First").cell("B2").value<int>(), 42);
+        xlnt_assert_equals(loaded.active_sheet().cell("A1").comment().plain_text(), "unchanged note");
+        xlnt_assert_equals(static_cast<const xlnt::workbook &>(loaded).sheet_by_index(0).title(), "First");
+        xlnt_assert(!loaded.sheet_by_title("First").cell("C3").has_value());
+
+        for (auto ws : loaded)
+        {
+            xlnt_assert(ws.calculate_dimension().width() >= 1);
+        }
+
+        std::vector<std::uint8_t> saved;
+        loaded.save(saved);
+        xlnt_assert(contains(saved, "<c r=\"B2\""));
+        xlnt_assert(contains(saved, "unchanged note"));
+        xlnt_assert(!contains(saved, "<c r=\"A1\" t=\"s\"><v>1</v></c>"));
+
+        xlnt::workbook reloaded;
+        reloaded.load(saved);
+        xlnt_assert_equals(reloaded.sheet_by_title("First").cell("A1").value<std::string>(), "kept");
+        xlnt_assert_equals(reloaded.sheet_by_title("First").cell("A1").comment().plain_text(), "unchanged note");
+        xlnt_assert_equals(reloaded.sheet_by_title("Second").cell("A1").value<std::string>(), "new");
+
+        // saving again copies the same parts, changing the worksheet stops that
+        std::vector<std::uint8_t> saved_again;
+        loaded.save(saved_again);
+        xlnt_assert(saved_again == saved);
+
+        loaded.sheet_by_title("First").cell("B2").value(43);
+        loaded.save(saved);
+        xlnt_assert(!contains(saved, "<c r=\"B2\""));
+        reloaded.load(saved);
+        xlnt_assert_equals(reloaded.sheet_by_title("First").cell("B2").value<int>(), 43);
+
+        loaded.load(original, load_options);
+        loaded.sheet_by_title("First").row_properties(3).height = 30.0;
+        loaded.save(saved);
+        xlnt_assert(!contains(saved, "<c r=\"B2\""));
+
+        // the first worksheet was saved as the selected one
+        loaded.load(original, load_options);
+        auto view = loaded.view();
+        view.active_tab = 1;
+        loaded.view(view);
+        loaded.save(saved);
+        xlnt_assert(!contains(saved, "<c r=\"B2\""));
+    }
+
+    void test_save_incremental()
+    {
+        temporary_file file;
+
+        {
+            xlnt::workbook wb;
+            wb.active_sheet().title("Data");
+            wb.active_sheet().cell("A1").value(1);
+            wb.create_sheet().title("Log");
+            wb.save(file.get_path());
+        }
+
+        xlnt::load_options options;
+        options.copy_unmodified_worksheets = true;
+        xlnt::workbook wb;
+        wb.load(file.get_path(), options);
+        wb.sheet_by_title("Log").cell("A1").value("appended");
+        wb.save_incremental(file.get_path());
+
+        xlnt_assert(!xlnt::path(file.get_path().string() + ".xlnt-tmp").exists());
+
+        xlnt::workbook loaded;
+        loaded.load(file.get_path());
+        xlnt_assert_equals(loaded.sheet_by_title("Data").cell("A1").value<int>(), 1);
+        xlnt_assert_equals(loaded.sheet_by_title("Log").cell("A1").value<std::string>(), "appended");
+
+        // the existing package is kept if the new one can't be written
+        xlnt::workbook invalid;
+        xlnt::page_setup setup;
+        setup.sheet_state(xlnt::sheet_state::hidden);
+        invalid.active_sheet().page_setup(setup);
+        xlnt_assert_throws(invalid.save_incremental(file.get_path()), xlnt::no_visible_worksheets);
+
+        loaded.load(file.get_path());
+        xlnt_assert_equals(loaded.sheet_by_title("Log").cell("A1").value<std::string>(), "appended");
+        xlnt_assert(!xlnt::path(file.get_path().string() + ".xlnt-tmp").exists());
+    }
+
+    void test_load_mapped_file()
+    {
+        temporary_file file;
+
+        for (auto level : {6, 0})
+        {
+            {
+                xlnt::workbook wb;
+                auto ws = wb.active_sheet();
+
+                for (xlnt::row_t row = 1; row <= 2000; ++row)
+                {
+                    ws.cell(1, row).value(static_cast<int>(row));
+                    ws.cell(2, row).value("text " + std::to_string(row));
+                }
+
+                xlnt::save_options options;
+                options.compression_level = level;
+                wb.save(file.get_path(), options);
+            }
+
+            // small buffers make inflate take its input from the mapping in many pieces
+            xlnt::load_options options;
+            options.buffer_size = 512;
+            xlnt::workbook loaded;
+            loaded.load(file.get_path(), options);
+            xlnt_assert_equals(loaded.active_sheet().cell("A2000").value<int>(), 2000);
+            xlnt_assert_equals(loaded.active_sheet().cell("B1000").value<std::string>(), "text 1000");
+
+            options.lazy_worksheets = true;
+            loaded.load(file.get_path(), options);
+            xlnt_assert_equals(loaded.active_sheet().cell("A1999").value<int>(), 1999);
+            xlnt_assert_equals(loaded.active_sheet().cell("B2000").value<std::string>(), "text 2000");
+        }
+
+        // files which can't be mapped are still reported as they were before
+        xlnt::workbook wb;
+        xlnt_assert_throws(wb.load(xlnt::path("missing.xlsx")), xlnt::exception);
+
+        {
+            std::ofstream empty(file.get_path().string());
+        }
+
+        xlnt_assert_throws(wb.load(file.get_path()), xlnt::exception);
+    }
+
+    void test_load_from_memory()
+    {
+        std::vector<std::uint8_t> data;
+
+        {
+            xlnt::workbook wb;
+            wb.active_sheet().cell("A1").value("first");
+            wb.create_sheet().cell("B2").value(2);
+            wb.save(data);
+        }
+
+        xlnt::workbook loaded;
+        loaded.load(data.data(), data.size());
+        xlnt_assert_equals(loaded.sheet_by_index(0).cell("A1").value<std::string>(), "first");
+        xlnt_assert_equals(loaded.sheet_by_index(1).cell("B2").value<int>(), 2);
+
+        // lazily loaded worksheets don't depend on data after load returns
+        {
+            auto copy = data;
+            xlnt::load_options options;
+            options.lazy_worksheets = true;
+            loaded.load(copy.data(), copy.size(), options);
+            std::fill(copy.begin(), copy.end(), std::uint8_t(0));
+        }
+
+        xlnt_assert_equals(loaded.sheet_by_index(1).cell("B2").value<int>(), 2);
+        xlnt_assert_throws(loaded.load(data.data(), 21), xlnt::exception);
+    }
+
+    void test_zip64_archive()
+    {
+        const auto large_text = std::string(3 * 1024 * 1024, 'x');
+        std::vector<std::uint8_t> data;
+
+        {
+            xlnt::detail::vector_ostreambuf buffer(data);
+            std::ostream stream(&buffer);
+            xlnt::detail::ozstream archive(stream);
+            archive.zip64(true);
+
+            std::ostream(archive.open(xlnt::path("deflated.txt")).get()) << "deflated";
+            std::ostream(archive.open(xlnt::path("stored.txt"), 0).get()) << "stored";
+            archive.compression_threads(2);
+            std::ostream(archive.open(xlnt::path("blocks.txt")).get()) << large_text;
+        }
+
+        // ZIP64 end of central directory record and locator
+        const auto bytes = std::string(data.begin(), data.end());
+        xlnt_assert_differs(bytes.find("PK\x06\x06"), std::string::npos);
+        xlnt_assert_differs(bytes.find("PK\x06\x07"), std::string::npos);
+
+        xlnt::detail::vector_istreambuf buffer(data);
+        std::istream stream(&buffer);
+        xlnt::detail::izstream archive(stream);
+        xlnt_assert_equals(archive.read(xlnt::path("deflated.txt")), "deflated");
+        xlnt_assert_equals(archive.read(xlnt::path("stored.txt")), "stored");
+        xlnt_assert(archive.read(xlnt::path("blocks.txt")) == large_text);
+
+        // copied entries keep working in an archive without ZIP64 records
+        xlnt::detail::zentries entries;
+        archive.copy(xlnt::path("deflated.txt"), entries);
+        std::vector<std::uint8_t> copy_data;
+
+        {
+            xlnt::detail::vector_ostreambuf copy_buffer(copy_data);
+            std::ostream copy_stream(&copy_buffer);
+            xlnt::detail::ozstream copy_archive(copy_stream);
+            copy_archive.append(entries);
+        }
+
+        xlnt::detail::vector_istreambuf copy_buffer(copy_data);
+        std::istream copy_stream(&copy_buffer);
+        xlnt_assert_equals(xlnt::detail::izstream(copy_stream).read(xlnt::path("deflated.txt")), "deflated");
+    }
+
+    void test_archive_part_names()
+    {
+        std::vector<std::uint8_t> data;
+
+        {
+            xlnt::detail::vector_ostreambuf buffer(data);
+            std::ostream stream(&buffer);
+            xlnt::detail::ozstream archive(stream);
+            std::ostream(archive.open(xlnt::path("xl/Workbook.xml")).get()) << "workbook";
+            std::ostream(archive.open(xlnt::path("docProps\\app.xml"), 0).get()) << "app";
+        }
+
+        // names are found the way OPC compares part names
+        xlnt::detail::izstream archive(data.data(), data.size());
+        xlnt_assert(archive.has_file(xlnt::path("/xl/workbook.xml")));
+        xlnt_assert(archive.has_file(xlnt::path("XL/WORKBOOK.XML")));
+        xlnt_assert(archive.has_file(xlnt::path("docProps/app.xml")));
+        xlnt_assert(!archive.has_file(xlnt::path("xl/workbook.xml.rels")));
+        xlnt_assert_throws(archive.open(xlnt::path("missing.xml")), xlnt::exception);
+
+        // files() keeps the names as they are in the archive
+        auto files = archive.files();
+        std::sort(files.begin(), files.end(),
+            [](const xlnt::path &a, const xlnt::path &b) { return a.string() < b.string(); });
+        xlnt_assert_equals(files.size(), 2);
+        xlnt_assert_equals(files.front().string(), "docProps\\app.xml");
+        xlnt_assert_equals(files.back().string(), "xl/Workbook.xml");
+
+        // later opens use the data offset found by the first
+        for (auto i = 0; i < 2; ++i)
+        {
+            xlnt_assert_equals(archive.read(xlnt::path("xl/workbook.xml")), "workbook");
+            xlnt_assert_equals(archive.read(xlnt::path("docprops/app.xml")), "app");
+        }
+    }
+
+    void test_crc32()
+    {
+        const std::string check = "123456789";
+        const auto check_data = reinterpret_cast<const std::uint8_t *>(check.data());
+        xlnt_assert_equals(xlnt::detail::update_crc32(0, check_data, check.size()), 0xcbf43926);
+        xlnt_assert_equals(xlnt::detail::update_crc32_portable(0, check_data, check.size()), 0xcbf43926);
+
+        // the hardware path, if there is one, handles every length and alignment and can be resumed
+        std::vector<std::uint8_t> data(1024);
+        for (std::size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = static_cast<std::uint8_t>(i * 31 + (i >> 3));
+        }
+
+        for (std::size_t offset = 0; offset < 4; ++offset)
+        {
+            for (std::size_t size = 0; size + offset <= data.size(); size += 7)
+            {
+                const auto expected = xlnt::detail::update_crc32_portable(0, data.data() + offset, size);
+                xlnt_assert_equals(xlnt::detail::update_crc32(0, data.data() + offset, size), expected);
+
+                const auto first = xlnt::detail::update_crc32(0, data.data() + offset, size / 3);
+                xlnt_assert_equals(xlnt::detail::update_crc32(first, data.data() + offset + size / 3, size - size / 3), expected);
+            }
+        }
+    }
+
+    void test_save_to_unseekable_stream()
+    {
+        // only appends, so the package has to be written without seeking back
+        class append_only_streambuf : public std::streambuf
+        {
+        public:
+            std::string data;
+
+        protected:
+            int overflow(int c)
+            {
+                if (c != traits_type::eof()) data.push_back(static_cast<char>(c));
+                return traits_type::not_eof(c);
+            }
+
+            std::streamsize xsputn(const char *s, std::streamsize n)
+            {
+                data.append(s, static_cast<std::size_t>(n));
+                return n;
+            }
+        };
+
+        xlnt::workbook wb;
+        wb.active_sheet().cell("A1").value("streamed");
+        wb.create_sheet().cell("B2").value(2);
+
+        append_only_streambuf buffer;
+        std::ostream stream(&buffer);
+        wb.save(stream);
+
+        // each file is followed by a data descriptor
+        xlnt_assert_differs(buffer.data.find("PK\x07\x08"), std::string::npos);
+
+        const auto read_uint16 = [&buffer](std::size_t offset) {
+            return static_cast<std::uint16_t>(static_cast<std::uint8_t>(buffer.data[offset])
+                | static_cast<std::uint8_t>(buffer.data[offset + 1]) << 8);
+        };
+
+        // so each local header has a ZIP64 extra field, which tells streaming readers
+        // that the sizes in the data descriptor are 64-bit
+        xlnt_assert_equals(buffer.data.compare(0, 4, "PK\x03\x04"), 0);
+        xlnt_assert_differs(read_uint16(6) & 0x08, 0);
+        xlnt_assert(read_uint16(4) >= 45);
+        const auto filename_length = read_uint16(26);
+        xlnt_assert_equals(read_uint16(28), 20);
+        xlnt_assert_equals(read_uint16(30 + filename_length), 0x0001);
+        xlnt_assert_equals(read_uint16(32 + filename_length), 16);
+
+        const auto descriptor = buffer.data.find("PK\x07\x08");
+        xlnt_assert_equals(buffer.data.compare(descriptor + 24, 4, "PK\x03\x04"), 0);
+
+        // a seekable stream gets the sizes in the local header, without an extra field
+        std::ostringstream seekable;
+        wb.save(seekable);
+        const auto seekable_data = seekable.str();
+        xlnt_assert_equals(seekable_data.find("PK\x07\x08"), std::string::npos);
+        xlnt_assert_equals(static_cast<std::uint8_t>(seekable_data[6]) & 0x08, 0);
+        xlnt_assert_equals(static_cast<std::uint8_t>(seekable_data[28]), 0);
+
+        // unless ZIP64 is asked for, which puts the sizes in a ZIP64 extra field
+        xlnt::save_options zip64_options;
+        zip64_options.zip64 = true;
+        std::ostringstream zip64;
+        wb.save(zip64, zip64_options);
+        const auto zip64_data = zip64.str();
+        const auto zip64_filename_length = static_cast<std::uint8_t>(zip64_data[26]);
+        xlnt_assert_equals(zip64_data.find("PK\x07\x08"), std::string::npos);
+        xlnt_assert_equals(static_cast<std::uint8_t>(zip64_data[4]), 45);
+        xlnt_assert_equals(static_cast<std::uint8_t>(zip64_data[28]), 20);
+        xlnt_assert_equals(static_cast<std::uint8_t>(zip64_data[30 + zip64_filename_length]), 0x01);
+        xlnt_assert_differs(zip64_data.find("PK\x06\x06"), std::string::npos);
+
+        xlnt::workbook zip64_loaded;
+        zip64_loaded.load(std::vector<std::uint8_t>(zip64_data.begin(), zip64_data.end()));
+        xlnt_assert_equals(zip64_loaded.sheet_by_index(0).cell("A1").value<std::string>(), "streamed");
+
+        xlnt::workbook loaded;
+        loaded.load(std::vector<std::uint8_t>(buffer.data.begin(), buffer.data.end()));
+        xlnt_assert_equals(loaded.sheet_by_index(0).cell("A1").value<std::string>(), "streamed");
+        xlnt_assert_equals(loaded.sheet_by_index(1).cell("B2").value<int>(), 2);
+    }
 };
 static serialization_test_suite x;
@@ -24,6 +24,7 @@
 #include <iostream>
 
 #include <xlnt/cell/cell.hpp>
+#include <xlnt/cell/comment.hpp>
 #include <xlnt/cell/hyperlink.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/column_properties.hpp>
@@ -112,6 +113,8 @@ public:
         register_test(test_delete_columns);
         register_test(test_insert_too_many);
         register_test(test_insert_delete_moves_merges);
+        register_test(test_sparse_cells);
+        register_test(test_cell_attributes_follow_cells);
     }
 
     void test_new_worksheet()
@@ -1582,5 +1585,118 @@ public:
             xlnt_assert_equals(merged, expected);
         }
     }
+
+    void test_sparse_cells()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        // a handle stays valid while many more cells are created around it
+        auto first = ws.cell("D40");
+        first.value(1.5);
+
+        const std::vector<xlnt::cell_reference> references = {"XFD1048576", "C5000", "A1", "Z17", "B17", "M33", "A17"};
+
+        for (const auto &reference : references)
+        {
+            ws.cell(reference).value(reference.to_string());
+        }
+
+        for (xlnt::row_t row = 100; row < 3100; row += 3)
+        {
+            ws.cell(xlnt::cell_reference(row % 50 + 1, row)).value(static_cast<int>(row));
+        }
+
+        xlnt_assert_equals(first.value<double>(), 1.5);
+        xlnt_assert_equals(ws.cell("D40").value<double>(), 1.5);
+
+        for (const auto &reference : references)
+        {
+            xlnt_assert_equals(ws.cell(reference).value<std::string>(), reference.to_string());
+        }
+
+        xlnt_assert(!ws.has_cell("C17"));
+        xlnt_assert(!ws.has_cell("A4999"));
+        xlnt_assert_equals(ws.lowest_row(), 1);
+        xlnt_assert_equals(ws.highest_row(), 1048576);
+        xlnt_assert_equals(ws.lowest_column(), "A");
+        xlnt_assert_equals(ws.highest_column(), "XFD");
+        xlnt_assert_equals(ws.calculate_dimension(), xlnt::range_reference("A1:XFD1048576"));
+
+        const auto &const_ws = ws;
+        xlnt_assert_throws(const_ws.cell("C17"), xlnt::key_not_found);
+
+        ws.clear_cell("XFD1048576");
+        ws.clear_cell("C5000");
+        ws.clear_row(17);
+
+        xlnt_assert(!ws.has_cell("XFD1048576"));
+        xlnt_assert(!ws.has_cell("B17"));
+        xlnt_assert(ws.has_cell("M33"));
+        xlnt_assert_equals(ws.highest_row(), 3097);
+        xlnt_assert_equals(ws.highest_column(), "AX");
+        xlnt_assert_equals(first.value<double>(), 1.5);
+
+        // cells are written in row-major order however they were created
+        wb.save("temp.xlsx");
+
+        xlnt::workbook wb2;
+        wb2.load("temp.xlsx");
+        auto ws2 = wb2.active_sheet();
+
+        xlnt_assert_equals(ws2.calculate_dimension(), ws.calculate_dimension());
+        xlnt_assert_equals(ws2.cell("M33").value<std::string>(), "M33");
+        xlnt_assert_equals(ws2.cell(xlnt::cell_reference(3097 % 50 + 1, 3097)).value<int>(), 3097);
+
+        auto copy = wb.copy_sheet(ws);
+        xlnt_assert_equals(copy.cell("D40").value<double>(), 1.5);
+        xlnt_assert(!copy.has_cell("A17"));
+    }
+
+    void test_cell_attributes_follow_cells()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        ws.cell("B2").formula("=SUM(A1:A3)");
+        ws.cell("B3").hyperlink("https://example.com", "example");
+        ws.cell("B4").comment("note", "author");
+        ws.cell("B5").error("#N/A");
+        ws.cell("C5").value(1);
+
+        // the formula, hyperlink, comment and text move with their cells
+        ws.insert_rows(3, 2);
+
+        xlnt_assert_equals(ws.cell("B2").formula(), "SUM(A1:A3)");
+        xlnt_assert(!ws.cell("B3").has_hyperlink());
+        xlnt_assert_equals(ws.cell("B5").hyperlink().url(), "https://example.com");
+        xlnt_assert_equals(ws.cell("B5").value<std::string>(), "example");
+        xlnt_assert(!ws.cell("B4").has_comment());
+        xlnt_assert_equals(ws.cell("B6").comment().plain_text(), "note");
+        xlnt_assert_equals(ws.cell("B7").error(), "#N/A");
+
+        ws.delete_columns(1, 1);
+
+        xlnt_assert_equals(ws.cell("A2").formula(), "SUM(A1:A3)");
+        xlnt_assert_equals(ws.cell("A7").error(), "#N/A");
+        xlnt_assert_equals(ws.cell("B7").value<int>(), 1);
+
+        // a copied worksheet has its own
+        auto copy = wb.copy_sheet(ws);
+        copy.cell("A2").formula("=1");
+        xlnt_assert_equals(ws.cell("A2").formula(), "SUM(A1:A3)");
+        xlnt_assert_equals(copy.cell("A6").comment().plain_text(), "note");
+
+        // and they're gone with the cell
+        ws.clear_cell("A2");
+        ws.clear_cell("A6");
+        xlnt_assert(!ws.cell("A2").has_formula());
+        xlnt_assert(!ws.cell("A6").has_comment());
+        xlnt_assert_throws(ws.cell("A2").formula(), xlnt::invalid_attribute);
+
+        ws.clear_row(7);
+        xlnt_assert_equals(ws.cell("A7").value<std::string>(), "");
+        xlnt_assert_equals(copy.cell("A7").error(), "#N/A");
+    }
 };
 static worksheet_test_suite x;